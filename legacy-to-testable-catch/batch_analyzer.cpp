@@ -0,0 +1,32 @@
+#include <batch_analyzer.hpp>
+#include <iostream>
+
+using namespace std;
+
+int main(int argc, char* argv[])
+{
+    if (argc < 2 || argc > 3)
+    {
+        cerr << "Usage: " << argv[0] << " <directory_or_glob> [<results_file>]\n";
+        return 1;
+    }
+
+    const string input = argv[1];
+    const string results_file = (argc == 3) ? argv[2] : "batch_results.txt";
+
+    try
+    {
+        Ver_2::BatchAnalyzer analyzer{{Ver_2::Statistics::avg, Ver_2::Statistics::min_max, Ver_2::Statistics::sum}};
+        BatchReport report = analyzer.run(input, results_file);
+
+        cout << report << "\n";
+        cout << "Results have been saved to " << results_file << "\n";
+    }
+    catch (const exception& e)
+    {
+        cerr << e.what() << "\n";
+        return 1;
+    }
+
+    return 0;
+}
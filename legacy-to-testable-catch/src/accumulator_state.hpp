@@ -0,0 +1,111 @@
+#ifndef ACCUMULATOR_STATE_HPP
+#define ACCUMULATOR_STATE_HPP
+
+#include <bit>
+#include <cstdint>
+#include <cstring>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <vector>
+
+// Byte representation of accumulator states - used to merge partial statistics calculated elsewhere.
+// State starts with the kind of accumulator, fields are stored as raw little-endian bytes.
+static_assert(std::endian::native == std::endian::little, "Accumulator states support only little-endian hosts");
+
+class StateWriter
+{
+    std::string bytes_;
+
+public:
+    explicit StateWriter(std::string_view kind)
+    {
+        write(kind);
+    }
+
+    template <typename T>
+        requires std::is_trivially_copyable_v<T>
+    void write(const T& value)
+    {
+        bytes_.append(reinterpret_cast<const char*>(&value), sizeof(T));
+    }
+
+    void write(std::string_view text)
+    {
+        write(static_cast<std::uint64_t>(text.size()));
+        bytes_.append(text);
+    }
+
+    template <typename T>
+        requires std::is_trivially_copyable_v<T>
+    void write_array(const T* values, std::size_t count)
+    {
+        write(static_cast<std::uint64_t>(count));
+        bytes_.append(reinterpret_cast<const char*>(values), count * sizeof(T));
+    }
+
+    std::string str() const
+    {
+        return bytes_;
+    }
+};
+
+class StateReader
+{
+    std::string_view bytes_;
+
+public:
+    StateReader(std::string_view bytes, std::string_view kind)
+        : bytes_{bytes}
+    {
+        if (read_text() != kind)
+            throw std::invalid_argument("Accumulator state of different kind!!!");
+    }
+
+    template <typename T>
+        requires std::is_trivially_copyable_v<T>
+    T read()
+    {
+        T value;
+        std::memcpy(&value, take(sizeof(T)).data(), sizeof(T));
+        return value;
+    }
+
+    std::string_view read_text()
+    {
+        auto size = read<std::uint64_t>();
+        return take(size);
+    }
+
+    template <typename T>
+        requires std::is_trivially_copyable_v<T>
+    std::vector<T> read_array()
+    {
+        auto count = read<std::uint64_t>();
+        if (count > bytes_.size() / sizeof(T))
+            throw std::runtime_error("Invalid accumulator state!!!");
+        std::vector<T> values(count);
+        if (count > 0)
+            std::memcpy(values.data(), take(count * sizeof(T)).data(), count * sizeof(T));
+        return values;
+    }
+
+    void expect_end() const
+    {
+        if (!bytes_.empty())
+            throw std::runtime_error("Invalid accumulator state!!!");
+    }
+
+private:
+    std::string_view take(std::size_t size)
+    {
+        if (size > bytes_.size())
+            throw std::runtime_error("Invalid accumulator state!!!");
+        auto taken = bytes_.substr(0, size);
+        bytes_.remove_prefix(size);
+        return taken;
+    }
+};
+
+#endif // ACCUMULATOR_STATE_HPP
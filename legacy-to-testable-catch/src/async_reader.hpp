@@ -0,0 +1,496 @@
+#ifndef ASYNC_READER_HPP
+#define ASYNC_READER_HPP
+
+#include "stream_reader.hpp"
+
+#include <algorithm>
+#include <cerrno>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <filesystem>
+#include <fstream>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <system_error>
+#include <thread>
+#include <vector>
+
+#if defined(__linux__) && __has_include(<linux/io_uring.h>)
+#include <atomic>
+#include <cstring>
+#include <fcntl.h>
+#include <linux/io_uring.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#ifdef IORING_FEAT_RW_CUR_POS // kernel headers with IORING_OP_READ
+#define ASYNC_READER_IO_URING
+#endif
+#endif
+
+namespace AsyncIo
+{
+    struct Buffer
+    {
+        std::vector<char> bytes;
+        std::size_t size = 0; // bytes read
+        bool ready = false;
+        bool failed = false;
+    };
+
+    // Reads of whole buffers - a submitted read is complete when wait() for its buffer returns
+    class IBackend
+    {
+    public:
+        virtual void submit(Buffer& buffer, std::uint64_t offset, std::size_t size) = 0;
+        virtual void wait(Buffer& buffer) = 0;
+        virtual ~IBackend() = default;
+    };
+
+    // One I/O thread reads requested buffers in order
+    class ThreadBackend : public IBackend
+    {
+        struct Request
+        {
+            Buffer* buffer;
+            std::uint64_t offset;
+            std::size_t size;
+        };
+
+        std::ifstream file_;
+        std::mutex mutex_;
+        std::condition_variable requested_;
+        std::condition_variable completed_;
+        std::deque<Request> requests_;
+        bool stopping_ = false;
+        std::thread thread_;
+
+        void run()
+        {
+            while (true)
+            {
+                Request request;
+                {
+                    std::unique_lock lock{mutex_};
+                    requested_.wait(lock, [this] { return !requests_.empty() || stopping_; });
+                    if (stopping_)
+                        return;
+                    request = requests_.front();
+                    requests_.pop_front();
+                }
+
+                file_.clear();
+                file_.seekg(static_cast<std::streamoff>(request.offset));
+                file_.read(request.buffer->bytes.data(), static_cast<std::streamsize>(request.size));
+                const auto bytes_read = static_cast<std::size_t>(file_.gcount());
+
+                {
+                    std::lock_guard lock{mutex_};
+                    request.buffer->size = bytes_read;
+                    request.buffer->failed = file_.bad();
+                    request.buffer->ready = true;
+                }
+                completed_.notify_all();
+            }
+        }
+
+    public:
+        explicit ThreadBackend(const std::string& file_name)
+            : file_{file_name, std::ios::binary}
+        {
+            if (!file_)
+                throw std::runtime_error("File not opened!!!");
+
+            thread_ = std::thread{[this] { run(); }};
+        }
+
+        ~ThreadBackend()
+        {
+            {
+                std::lock_guard lock{mutex_};
+                stopping_ = true;
+            }
+            requested_.notify_all();
+            thread_.join();
+        }
+
+        void submit(Buffer& buffer, std::uint64_t offset, std::size_t size) override
+        {
+            {
+                std::lock_guard lock{mutex_};
+                buffer.ready = false;
+                requests_.push_back(Request{&buffer, offset, size});
+            }
+            requested_.notify_one();
+        }
+
+        void wait(Buffer& buffer) override
+        {
+            std::unique_lock lock{mutex_};
+            completed_.wait(lock, [&buffer] { return buffer.ready; });
+        }
+    };
+
+#ifdef ASYNC_READER_IO_URING
+    // Reads submitted to an io_uring instance (raw system calls - no liburing needed).
+    // Short reads are resubmitted for the rest of the buffer.
+    class IoUringBackend : public IBackend
+    {
+        struct Request
+        {
+            Buffer* buffer;
+            std::uint64_t offset;
+            std::size_t size;
+        };
+
+        int file_fd_ = -1;
+        int ring_fd_ = -1;
+        void* sq_ring_ = MAP_FAILED;
+        void* cq_ring_ = MAP_FAILED;
+        void* sqes_ = MAP_FAILED;
+        std::size_t sq_ring_size_ = 0;
+        std::size_t cq_ring_size_ = 0;
+        std::size_t sqes_size_ = 0;
+
+        unsigned* sq_tail_ = nullptr;
+        unsigned* sq_mask_ = nullptr;
+        unsigned* sq_array_ = nullptr;
+        unsigned* cq_head_ = nullptr;
+        unsigned* cq_tail_ = nullptr;
+        unsigned* cq_mask_ = nullptr;
+        io_uring_cqe* cqes_ = nullptr;
+
+        std::vector<Request> requests_; // slot of a read in flight is its user_data
+        std::vector<std::size_t> free_slots_;
+        std::size_t in_flight_ = 0;
+
+        static int enter(int ring_fd, unsigned to_submit, unsigned min_complete, unsigned flags)
+        {
+            return static_cast<int>(syscall(__NR_io_uring_enter, ring_fd, to_submit, min_complete, flags, nullptr, 0));
+        }
+
+        void release()
+        {
+            if (sqes_ != MAP_FAILED)
+                munmap(sqes_, sqes_size_);
+            if (cq_ring_ != MAP_FAILED && cq_ring_ != sq_ring_)
+                munmap(cq_ring_, cq_ring_size_);
+            if (sq_ring_ != MAP_FAILED)
+                munmap(sq_ring_, sq_ring_size_);
+            if (ring_fd_ >= 0)
+                close(ring_fd_);
+            if (file_fd_ >= 0)
+                close(file_fd_);
+        }
+
+        void push(const Request& request)
+        {
+            const std::size_t slot = free_slots_.back();
+            free_slots_.pop_back();
+            requests_[slot] = request;
+
+            const unsigned tail = *sq_tail_;
+            const unsigned index = tail & *sq_mask_;
+            auto& sqe = static_cast<io_uring_sqe*>(sqes_)[index];
+            std::memset(&sqe, 0, sizeof(sqe));
+            sqe.opcode = IORING_OP_READ;
+            sqe.fd = file_fd_;
+            sqe.addr = reinterpret_cast<std::uint64_t>(request.buffer->bytes.data() + request.buffer->size);
+            sqe.len = static_cast<std::uint32_t>(request.size);
+            sqe.off = request.offset;
+            sqe.user_data = slot;
+            sq_array_[index] = index;
+            std::atomic_ref<unsigned>{*sq_tail_}.store(tail + 1, std::memory_order_release);
+
+            ++in_flight_;
+            while (enter(ring_fd_, 1, 0, 0) < 0)
+                if (errno != EINTR && errno != EAGAIN)
+                    throw std::runtime_error("File not read!!!");
+        }
+
+        void complete(std::size_t slot, int result)
+        {
+            Request request = requests_[slot];
+            free_slots_.push_back(slot);
+            --in_flight_;
+
+            if (result == -EINTR || result == -EAGAIN)
+            {
+                push(request);
+                return;
+            }
+
+            if (result < 0)
+            {
+                request.buffer->failed = true;
+                request.buffer->ready = true;
+                return;
+            }
+
+            request.buffer->size += static_cast<std::size_t>(result);
+            if (result > 0 && static_cast<std::size_t>(result) < request.size) // short read
+            {
+                push(Request{request.buffer, request.offset + result, request.size - result});
+                return;
+            }
+
+            request.buffer->ready = true;
+        }
+
+        void reap()
+        {
+            unsigned head = *cq_head_;
+            const unsigned tail = std::atomic_ref<unsigned>{*cq_tail_}.load(std::memory_order_acquire);
+            for (; head != tail; ++head)
+            {
+                const io_uring_cqe& cqe = cqes_[head & *cq_mask_];
+                const auto slot = static_cast<std::size_t>(cqe.user_data);
+                const int result = cqe.res;
+                std::atomic_ref<unsigned>{*cq_head_}.store(head + 1, std::memory_order_release);
+                complete(slot, result);
+            }
+        }
+
+        void wait_for_completion()
+        {
+            if (enter(ring_fd_, 0, 1, IORING_ENTER_GETEVENTS) < 0 && errno != EINTR)
+                throw std::runtime_error("File not read!!!");
+            reap();
+        }
+
+    public:
+        // throws std::system_error when io_uring is not available (old kernel, disabled by seccomp)
+        IoUringBackend(const std::string& file_name, unsigned queue_depth)
+        {
+            file_fd_ = open(file_name.c_str(), O_RDONLY | O_CLOEXEC);
+            if (file_fd_ < 0)
+                throw std::runtime_error("File not opened!!!");
+
+            io_uring_params params{};
+            ring_fd_ = static_cast<int>(syscall(__NR_io_uring_setup, queue_depth, &params));
+            if (ring_fd_ < 0 || !(params.features & IORING_FEAT_RW_CUR_POS))
+            {
+                release();
+                throw std::system_error(ENOSYS, std::generic_category(), "io_uring not available");
+            }
+
+            sq_ring_size_ = params.sq_off.array + params.sq_entries * sizeof(unsigned);
+            cq_ring_size_ = params.cq_off.cqes + params.cq_entries * sizeof(io_uring_cqe);
+            const bool single_mmap = params.features & IORING_FEAT_SINGLE_MMAP;
+            if (single_mmap)
+                sq_ring_size_ = cq_ring_size_ = std::max(sq_ring_size_, cq_ring_size_);
+            sqes_size_ = params.sq_entries * sizeof(io_uring_sqe);
+
+            sq_ring_ = mmap(nullptr, sq_ring_size_, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, ring_fd_, IORING_OFF_SQ_RING);
+            cq_ring_ = single_mmap ? sq_ring_
+                                   : mmap(nullptr, cq_ring_size_, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, ring_fd_, IORING_OFF_CQ_RING);
+            sqes_ = mmap(nullptr, sqes_size_, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, ring_fd_, IORING_OFF_SQES);
+            if (sq_ring_ == MAP_FAILED || cq_ring_ == MAP_FAILED || sqes_ == MAP_FAILED)
+            {
+                release();
+                throw std::system_error(ENOSYS, std::generic_category(), "io_uring not available");
+            }
+
+            auto* sq = static_cast<char*>(sq_ring_);
+            auto* cq = static_cast<char*>(cq_ring_);
+            sq_tail_ = reinterpret_cast<unsigned*>(sq + params.sq_off.tail);
+            sq_mask_ = reinterpret_cast<unsigned*>(sq + params.sq_off.ring_mask);
+            sq_array_ = reinterpret_cast<unsigned*>(sq + params.sq_off.array);
+            cq_head_ = reinterpret_cast<unsigned*>(cq + params.cq_off.head);
+            cq_tail_ = reinterpret_cast<unsigned*>(cq + params.cq_off.tail);
+            cq_mask_ = reinterpret_cast<unsigned*>(cq + params.cq_off.ring_mask);
+            cqes_ = reinterpret_cast<io_uring_cqe*>(cq + params.cq_off.cqes);
+
+            requests_.resize(params.sq_entries);
+            for (std::size_t slot = requests_.size(); slot > 0; --slot)
+                free_slots_.push_back(slot - 1);
+        }
+
+        IoUringBackend(const IoUringBackend&) = delete;
+        IoUringBackend& operator=(const IoUringBackend&) = delete;
+
+        ~IoUringBackend()
+        {
+            // buffers must not be freed while the kernel still writes to them
+            while (in_flight_ > 0)
+            {
+                if (enter(ring_fd_, 0, 1, IORING_ENTER_GETEVENTS) < 0 && errno != EINTR)
+                    break;
+
+                unsigned head = *cq_head_;
+                const unsigned tail = std::atomic_ref<unsigned>{*cq_tail_}.load(std::memory_order_acquire);
+                in_flight_ -= tail - head;
+                std::atomic_ref<unsigned>{*cq_head_}.store(tail, std::memory_order_release);
+            }
+            release();
+        }
+
+        void submit(Buffer& buffer, std::uint64_t offset, std::size_t size) override
+        {
+            buffer.ready = false;
+            buffer.size = 0;
+            push(Request{&buffer, offset, size});
+        }
+
+        void wait(Buffer& buffer) override
+        {
+            while (!buffer.ready)
+                wait_for_completion();
+        }
+    };
+#endif
+}
+
+// Reads a file sequentially with buffer_count buffers in flight - while the caller processes one block,
+// reads of the following ones are already running (io_uring on Linux, otherwise an I/O thread).
+class AsyncFileReader
+{
+public:
+    enum class Backend
+    {
+        automatic,
+        io_uring,
+        threads
+    };
+
+    static constexpr std::size_t default_buffer_count = 4;
+    static constexpr std::size_t default_buffer_size = 1024 * 1024;
+
+private:
+    std::vector<AsyncIo::Buffer> buffers_;
+    std::unique_ptr<AsyncIo::IBackend> backend_;
+    Backend backend_type_ = Backend::threads;
+    std::size_t buffer_size_;
+    std::uint64_t block_count_;
+    std::uint64_t next_block_ = 0;
+
+    void submit(std::uint64_t block)
+    {
+        backend_->submit(buffers_[block % buffers_.size()], block * buffer_size_, buffer_size_);
+    }
+
+public:
+    explicit AsyncFileReader(const std::string& file_name, std::size_t buffer_count = default_buffer_count, std::size_t buffer_size = default_buffer_size,
+        Backend backend = Backend::automatic)
+        : buffers_(std::max<std::size_t>(buffer_count, 1))
+        , buffer_size_{std::max<std::size_t>(buffer_size, 1)}
+    {
+        std::error_code ec;
+        const std::uint64_t file_size = std::filesystem::file_size(file_name, ec);
+        if (ec)
+            throw std::runtime_error("File not opened!!!");
+        block_count_ = (file_size + buffer_size_ - 1) / buffer_size_;
+
+        for (auto& buffer : buffers_)
+            buffer.bytes.resize(buffer_size_);
+
+#ifdef ASYNC_READER_IO_URING
+        if (backend != Backend::threads)
+        {
+            try
+            {
+                backend_ = std::make_unique<AsyncIo::IoUringBackend>(file_name, static_cast<unsigned>(buffers_.size()));
+                backend_type_ = Backend::io_uring;
+            }
+            catch (const std::system_error&)
+            {
+                if (backend == Backend::io_uring)
+                    throw;
+            }
+        }
+#else
+        if (backend == Backend::io_uring)
+            throw std::system_error(ENOSYS, std::generic_category(), "io_uring not available");
+#endif
+        if (!backend_)
+            backend_ = std::make_unique<AsyncIo::ThreadBackend>(file_name);
+
+        for (std::uint64_t block = 0; block < std::min<std::uint64_t>(buffers_.size(), block_count_); ++block)
+            submit(block);
+    }
+
+    AsyncFileReader(const AsyncFileReader&) = delete;
+    AsyncFileReader& operator=(const AsyncFileReader&) = delete;
+
+    ~AsyncFileReader()
+    {
+        backend_.reset(); // waits for reads in flight before buffers are freed
+    }
+
+    // Next block of the file - an empty one at the end. The block is valid until the next call,
+    // which reuses its buffer for the read of block + buffer_count.
+    std::string_view next()
+    {
+        if (next_block_ > 0 && next_block_ - 1 + buffers_.size() < block_count_)
+            submit(next_block_ - 1 + buffers_.size());
+
+        if (next_block_ >= block_count_)
+            return {};
+
+        auto& buffer = buffers_[next_block_ % buffers_.size()];
+        backend_->wait(buffer);
+        if (buffer.failed)
+            throw std::runtime_error("File not read!!!");
+
+        if (buffer.size < buffer_size_) // file was truncated while it was read
+            block_count_ = next_block_ + 1;
+        ++next_block_;
+
+        Metrics::add_bytes_read(buffer.size);
+        return {buffer.bytes.data(), buffer.size};
+    }
+
+    Backend backend() const
+    {
+        return backend_type_;
+    }
+};
+
+// DataStreamReader that parses blocks of text while the following ones are being read
+class AsyncStreamReader
+{
+    std::size_t chunk_size_;
+    std::size_t buffer_count_;
+    std::size_t buffer_size_;
+    AsyncFileReader::Backend backend_;
+
+public:
+    explicit AsyncStreamReader(std::size_t chunk_size = TextStreamReader::default_chunk_size, std::size_t buffer_count = AsyncFileReader::default_buffer_count,
+        std::size_t buffer_size = AsyncFileReader::default_buffer_size, AsyncFileReader::Backend backend = AsyncFileReader::Backend::automatic)
+        : chunk_size_{std::max<std::size_t>(chunk_size, 1)}
+        , buffer_count_{buffer_count}
+        , buffer_size_{buffer_size}
+        , backend_{backend}
+    {
+    }
+
+    void operator()(const std::string& file_name, const ChunkConsumer& consume) const
+    {
+        AsyncFileReader reader{file_name, buffer_count_, buffer_size_, backend_};
+
+        parse_text_blocks([&reader] { return reader.next(); }, chunk_size_, consume);
+    }
+};
+
+inline void async_stream_reader(const std::string& file_name, const ChunkConsumer& consume)
+{
+    AsyncStreamReader{}(file_name, consume);
+}
+
+// DataReader for DataAnalyzer::load_data - parsing overlaps with reading of the file
+inline Data async_text_reader(const std::string& file_name)
+{
+    Data data;
+    Metrics::GrowthCounter growth{data};
+    async_stream_reader(file_name, [&](std::span<const double> values) {
+        data.insert(data.end(), values.begin(), values.end());
+        growth.update();
+    });
+    return data;
+}
+
+#endif // ASYNC_READER_HPP
@@ -0,0 +1,205 @@
+#ifndef BATCH_ANALYZER_HPP
+#define BATCH_ANALYZER_HPP
+
+#include "data_analyzer.hpp"
+#include "mmap_reader.hpp"
+#include "work_stealing_pool.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <memory>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+// '*' matches any sequence of characters, '?' any single character
+inline bool matches_wildcard(std::string_view pattern, std::string_view text)
+{
+    std::size_t p = 0, t = 0;
+    std::size_t star = std::string_view::npos, star_text = 0;
+
+    while (t < text.size())
+    {
+        if (p < pattern.size() && (pattern[p] == '?' || pattern[p] == text[t]))
+        {
+            ++p;
+            ++t;
+        }
+        else if (p < pattern.size() && pattern[p] == '*')
+        {
+            star = p++;
+            star_text = t;
+        }
+        else if (star != std::string_view::npos)
+        {
+            p = star + 1;
+            t = ++star_text;
+        }
+        else
+        {
+            return false;
+        }
+    }
+
+    while (p < pattern.size() && pattern[p] == '*')
+        ++p;
+    return p == pattern.size();
+}
+
+// Regular files of a directory or files matching a glob - wildcards are allowed only in the file name
+// (e.g. "data/*.dat"). Files are sorted by name.
+inline std::vector<std::string> list_files(const std::string& directory_or_glob)
+{
+    namespace fs = std::filesystem;
+
+    fs::path path{directory_or_glob};
+    fs::path directory = path;
+    std::string pattern = "*";
+    if (!fs::is_directory(path))
+    {
+        directory = path.has_parent_path() ? path.parent_path() : fs::path{"."};
+        pattern = path.filename().string();
+    }
+
+    if (!fs::is_directory(directory))
+        throw std::runtime_error("Directory not found!!!");
+
+    std::vector<std::string> files;
+    for (const auto& entry : fs::directory_iterator{directory})
+        if (entry.is_regular_file() && matches_wildcard(pattern, entry.path().filename().string()))
+            files.push_back(entry.path().string());
+
+    std::sort(files.begin(), files.end());
+    return files;
+}
+
+struct BatchReport
+{
+    std::size_t file_count = 0;
+    std::size_t failed_count = 0;
+    std::uint64_t bytes = 0;
+    double seconds = 0.0;
+
+    double files_per_second() const
+    {
+        return seconds > 0.0 ? file_count / seconds : 0.0;
+    }
+
+    double megabytes_per_second() const
+    {
+        return seconds > 0.0 ? bytes / (1024.0 * 1024.0) / seconds : 0.0;
+    }
+};
+
+inline std::ostream& operator<<(std::ostream& out, const BatchReport& report)
+{
+    out << report.file_count << " files (" << report.failed_count << " failed, " << report.bytes / (1024.0 * 1024.0) << " MB) in "
+        << report.seconds << " s - " << report.files_per_second() << " files/s, " << report.megabytes_per_second() << " MB/s";
+    return out;
+}
+
+namespace Ver_2
+{
+    // Loads and calculates statistics of many files on a work-stealing pool. Consecutive small files are batched
+    // into one task until they reach batch_bytes, so scheduling cost is amortized. Results of all files are written
+    // to one file in the order of input files: "<file>: <description> = <value>", or "<file>: error: <message>".
+    class BatchAnalyzer
+    {
+        std::vector<std::shared_ptr<IStatistics>> stats_;
+        DataReader reader_;
+        std::size_t thread_count_;
+        std::uint64_t batch_bytes_;
+
+    public:
+        static constexpr std::uint64_t default_batch_bytes = 1024 * 1024;
+        static constexpr std::size_t max_batch_files = 256;
+
+        explicit BatchAnalyzer(std::vector<std::shared_ptr<IStatistics>> stats, DataReader reader = mmap_reader,
+            std::size_t thread_count = std::thread::hardware_concurrency(), std::uint64_t batch_bytes = default_batch_bytes)
+            : stats_{std::move(stats)}
+            , reader_{reader}
+            , thread_count_{thread_count}
+            , batch_bytes_{batch_bytes}
+        {
+        }
+
+        BatchReport run(const std::string& directory_or_glob, const std::string& results_file) const
+        {
+            return run(list_files(directory_or_glob), results_file);
+        }
+
+        BatchReport run(const std::vector<std::string>& files, const std::string& results_file) const
+        {
+            const auto start = std::chrono::steady_clock::now();
+
+            std::vector<std::uint64_t> sizes(files.size());
+            std::vector<std::string> outputs(files.size());
+            std::vector<char> failed(files.size());
+
+            auto analyze = [&](std::size_t i) {
+                std::ostringstream out;
+                try
+                {
+                    for (const auto& result : calculate_fused(stats_, reader_(files[i])))
+                        out << files[i] << ": " << result.description << " = " << result.value << "\n";
+                }
+                catch (const std::exception& e)
+                {
+                    out << files[i] << ": error: " << e.what() << "\n";
+                    failed[i] = true;
+                }
+                outputs[i] = out.str();
+            };
+
+            {
+                WorkStealingPool pool{thread_count_};
+
+                std::size_t first = 0;
+                std::uint64_t batch_size = 0;
+                for (std::size_t i = 0; i < files.size(); ++i)
+                {
+                    std::error_code ec;
+                    sizes[i] = std::filesystem::file_size(files[i], ec);
+                    if (ec)
+                        sizes[i] = 0;
+                    batch_size += sizes[i];
+
+                    if (batch_size >= batch_bytes_ || i + 1 - first == max_batch_files || i + 1 == files.size())
+                    {
+                        pool.submit([&analyze, first, last = i + 1] {
+                            for (std::size_t j = first; j < last; ++j)
+                                analyze(j);
+                        });
+                        first = i + 1;
+                        batch_size = 0;
+                    }
+                }
+
+                pool.wait();
+            }
+
+            std::ofstream fout{results_file, std::ios::binary};
+            if (!fout)
+                throw std::runtime_error("File not opened!!!");
+            for (const auto& output : outputs)
+                fout << output;
+
+            BatchReport report;
+            report.file_count = files.size();
+            report.failed_count = static_cast<std::size_t>(std::count(failed.begin(), failed.end(), true));
+            for (std::size_t i = 0; i < files.size(); ++i)
+                if (!failed[i])
+                    report.bytes += sizes[i];
+            report.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+            return report;
+        }
+    };
+}
+
+#endif // BATCH_ANALYZER_HPP
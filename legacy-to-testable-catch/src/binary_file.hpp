@@ -0,0 +1,128 @@
+#ifndef BINARY_FILE_HPP
+#define BINARY_FILE_HPP
+
+#include "checksum.hpp"
+#include "mapped_file.hpp"
+
+#include <bit>
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <stdexcept>
+#include <string>
+
+// Binary file layout (all fields little-endian):
+//   header    - BinaryHeader (32 bytes)
+//   checksums - block_count x uint64_t, one per block of block_size elements
+//   values    - count x element (raw IEEE-754 for floating point types, two's complement for integers)
+namespace BinaryFormat
+{
+    inline constexpr char magic[4] = {'T', 'D', 'D', 'B'};
+    inline constexpr std::uint32_t version = 1;
+    inline constexpr std::uint32_t default_block_size = 64 * 1024;
+
+    enum class ElementType : std::uint16_t
+    {
+        float64 = 1,
+        float32 = 2,
+        int32 = 3,
+        int64 = 4
+    };
+
+    // 0 for an unknown type
+    constexpr std::uint32_t element_size_of(ElementType element_type)
+    {
+        switch (element_type)
+        {
+        case ElementType::float64:
+        case ElementType::int64:
+            return 8;
+        case ElementType::float32:
+        case ElementType::int32:
+            return 4;
+        }
+        return 0;
+    }
+
+    struct BinaryHeader
+    {
+        char magic[4];
+        std::uint16_t version;
+        ElementType element_type;
+        std::uint32_t element_size;
+        std::uint32_t block_size;
+        std::uint64_t count;
+        std::uint64_t block_count;
+    };
+
+    static_assert(sizeof(BinaryHeader) == 32);
+    static_assert(std::endian::native == std::endian::little, "BinaryFormat supports only little-endian hosts");
+
+    inline std::uint64_t checksum(const void* bytes, std::size_t size)
+    {
+        return fnv1a_checksum(bytes, size);
+    }
+
+    inline bool is_binary_file(const std::string& file_name)
+    {
+        std::ifstream in{file_name, std::ios::binary};
+        char file_magic[sizeof(magic)] = {};
+        in.read(file_magic, sizeof(file_magic));
+        return in && std::memcmp(file_magic, magic, sizeof(magic)) == 0;
+    }
+
+    // Binary data file mapped into memory with a validated header - values and checksums are not verified,
+    // so any range of values can be read without touching the rest of the file
+    class BinaryFile
+    {
+        MappedFile file_;
+        BinaryHeader header_;
+
+    public:
+        explicit BinaryFile(const std::string& file_name)
+            : file_{file_name}
+        {
+            if (file_.size() < sizeof(header_))
+                throw std::runtime_error("Invalid binary data file!!!");
+            std::memcpy(&header_, file_.data(), sizeof(header_));
+
+            if (std::memcmp(header_.magic, magic, sizeof(magic)) != 0 || header_.version != version)
+                throw std::runtime_error("Invalid binary data file!!!");
+            if (header_.element_size == 0 || header_.element_size != element_size_of(header_.element_type) || header_.block_size == 0)
+                throw std::runtime_error("Unsupported element type!!!");
+
+            // sizes are bounded by the file size before they are multiplied, so a crafted header cannot wrap them
+            const std::uint64_t payload_size = file_.size() - sizeof(header_);
+            if (header_.count > payload_size / header_.element_size
+                || header_.block_count != header_.count / header_.block_size + (header_.count % header_.block_size != 0)
+                || header_.block_count != (payload_size - header_.count * header_.element_size) / sizeof(std::uint64_t)
+                || (payload_size - header_.count * header_.element_size) % sizeof(std::uint64_t) != 0)
+                throw std::runtime_error("Invalid binary data file!!!");
+        }
+
+        const BinaryHeader& header() const
+        {
+            return header_;
+        }
+
+        // size of the whole file in bytes
+        std::size_t size() const
+        {
+            return file_.size();
+        }
+
+        // block_count x uint64_t
+        const char* checksums() const
+        {
+            return file_.data() + sizeof(header_);
+        }
+
+        // count x element
+        const char* values() const
+        {
+            return checksums() + header_.block_count * sizeof(std::uint64_t);
+        }
+    };
+}
+
+#endif // BINARY_FILE_HPP
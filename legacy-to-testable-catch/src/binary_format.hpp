@@ -0,0 +1,108 @@
+#ifndef BINARY_FORMAT_HPP
+#define BINARY_FORMAT_HPP
+
+#include "binary_file.hpp"
+#include "data_analyzer.hpp"
+
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+namespace BinaryFormat
+{
+    template <DataElement T>
+    constexpr ElementType element_type_of()
+    {
+        if constexpr (std::same_as<T, double>)
+            return ElementType::float64;
+        else if constexpr (std::same_as<T, float>)
+            return ElementType::float32;
+        else if constexpr (std::same_as<T, std::int32_t>)
+            return ElementType::int32;
+        else
+            return ElementType::int64;
+    }
+
+    template <DataElement T>
+    std::vector<std::uint64_t> block_checksums(const T* values, std::uint64_t count, std::uint32_t block_size)
+    {
+        std::vector<std::uint64_t> checksums;
+        checksums.reserve((count + block_size - 1) / block_size);
+
+        for (std::uint64_t first = 0; first < count; first += block_size)
+        {
+            std::uint64_t length = std::min<std::uint64_t>(block_size, count - first);
+            checksums.push_back(checksum(values + first, length * sizeof(T)));
+        }
+
+        return checksums;
+    }
+}
+
+template <DataElement T>
+void binary_writer(const std::string& file_name, const BasicData<T>& data)
+{
+    using namespace BinaryFormat;
+
+    std::ofstream out{file_name, std::ios::binary};
+
+    if (!out)
+        throw std::runtime_error("File not opened!!!");
+
+    auto checksums = block_checksums(data.data(), data.size(), default_block_size);
+
+    BinaryHeader header{};
+    std::memcpy(header.magic, magic, sizeof(magic));
+    header.version = version;
+    header.element_type = element_type_of<T>();
+    header.element_size = sizeof(T);
+    header.block_size = default_block_size;
+    header.count = data.size();
+    header.block_count = checksums.size();
+
+    out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    out.write(reinterpret_cast<const char*>(checksums.data()), checksums.size() * sizeof(std::uint64_t));
+    out.write(reinterpret_cast<const char*>(data.data()), data.size() * sizeof(T));
+
+    if (!out)
+        throw std::runtime_error("File not written!!!");
+}
+
+// element type of file must be T - values are not converted
+template <DataElement T>
+BasicData<T> basic_binary_reader(const std::string& file_name)
+{
+    using namespace BinaryFormat;
+
+    BinaryFile file{file_name};
+    const BinaryHeader& header = file.header();
+    if (header.element_type != element_type_of<T>())
+        throw std::runtime_error("Unsupported element type!!!");
+
+    Metrics::add_bytes_read(file.size());
+    Metrics::ScopedPhase phase{Metrics::Phase::parse};
+
+    BasicData<T> data(header.count);
+    Metrics::add_allocation(data.size() * sizeof(T));
+    std::memcpy(data.data(), file.values(), header.count * sizeof(T));
+
+    std::vector<std::uint64_t> stored_checksums(header.block_count);
+    std::memcpy(stored_checksums.data(), file.checksums(), header.block_count * sizeof(std::uint64_t));
+
+    if (stored_checksums != block_checksums(data.data(), data.size(), header.block_size))
+        throw std::runtime_error("Binary data file is corrupted!!!");
+
+    Metrics::add_values_parsed(data.size());
+
+    return data;
+}
+
+inline Data binary_reader(const std::string& file_name)
+{
+    return basic_binary_reader<double>(file_name);
+}
+
+#endif // BINARY_FORMAT_HPP
@@ -0,0 +1,26 @@
+#ifndef CHECKSUM_HPP
+#define CHECKSUM_HPP
+
+#include <cstdint>
+#include <cstring>
+
+// 64-bit FNV-1a over 8-byte words
+inline std::uint64_t fnv1a_checksum(const void* bytes, std::size_t size)
+{
+    const auto* first = static_cast<const unsigned char*>(bytes);
+    std::uint64_t hash = 14695981039346656037ull;
+
+    std::size_t i = 0;
+    for (; i + sizeof(std::uint64_t) <= size; i += sizeof(std::uint64_t))
+    {
+        std::uint64_t word;
+        std::memcpy(&word, first + i, sizeof(word));
+        hash = (hash ^ word) * 1099511628211ull;
+    }
+    for (; i < size; ++i)
+        hash = (hash ^ first[i]) * 1099511628211ull;
+
+    return hash;
+}
+
+#endif // CHECKSUM_HPP
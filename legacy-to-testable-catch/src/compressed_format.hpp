@@ -0,0 +1,532 @@
+#ifndef COMPRESSED_FORMAT_HPP
+#define COMPRESSED_FORMAT_HPP
+
+#include "binary_format.hpp"
+#include "mapped_file.hpp"
+#include "stream_reader.hpp"
+
+#include <algorithm>
+#include <bit>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <span>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+// Lossless compressed file layout (all fields little-endian):
+//   header - FileHeader (32 bytes)
+//   blocks - block_count x (BlockHeader (32 bytes), payload of payload_size bytes)
+// Every block of at most block_size values is encoded on its own:
+//   delta - integer valued blocks: differences of consecutive values, zigzag encoded and bit-packed with
+//           the width of the largest one (first value is stored in the block header)
+//   xor   - Gorilla encoding: XOR with the previous value, only its meaningful bits are stored
+//           ('0' - same value, '10' - bits in the window of the previous XOR, '11' + 6 bits of leading zeros
+//           + 6 bits of length - 1 + bits)
+//   raw   - values as they are, when XOR encoding would be larger
+// Bits are packed from the least significant bit of each byte. Payload ends with padding bytes,
+// so decoders can always load whole 64-bit words.
+namespace CompressedFormat
+{
+    inline constexpr char magic[4] = {'T', 'D', 'C', 'Z'};
+    inline constexpr std::uint16_t version = 1;
+    inline constexpr std::uint32_t default_block_size = 8 * 1024;
+    inline constexpr std::uint32_t max_block_size = 1024 * 1024;
+    inline constexpr std::size_t padding = 16;
+
+    enum class Encoding : std::uint8_t
+    {
+        raw = 0,
+        delta = 1,
+        xor_float = 2
+    };
+
+    struct FileHeader
+    {
+        char magic[4];
+        std::uint16_t version;
+        std::uint16_t reserved;
+        std::uint32_t block_size;
+        std::uint32_t reserved2;
+        std::uint64_t count;
+        std::uint64_t block_count;
+    };
+
+    struct BlockHeader
+    {
+        Encoding encoding;
+        std::uint8_t bit_width; // of packed deltas
+        std::uint16_t reserved;
+        std::uint32_t count;
+        std::uint64_t payload_size;
+        std::uint64_t first; // int64 for delta blocks, IEEE-754 bits otherwise
+        std::uint64_t checksum; // of payload
+    };
+
+    static_assert(sizeof(FileHeader) == 32);
+    static_assert(sizeof(BlockHeader) == 32);
+    static_assert(std::endian::native == std::endian::little, "CompressedFormat supports only little-endian hosts");
+
+    class BitWriter
+    {
+        std::vector<unsigned char>& bytes_;
+        std::uint64_t buffer_ = 0;
+        unsigned fill_ = 0;
+
+        void store(std::uint64_t word, std::size_t size)
+        {
+            const auto* first = reinterpret_cast<const unsigned char*>(&word);
+            bytes_.insert(bytes_.end(), first, first + size);
+        }
+
+    public:
+        explicit BitWriter(std::vector<unsigned char>& bytes)
+            : bytes_{bytes}
+        {
+        }
+
+        // count <= 64, bits above count must be zero
+        void write(std::uint64_t bits, unsigned count)
+        {
+            buffer_ |= bits << fill_;
+            if (fill_ + count < 64)
+            {
+                fill_ += count;
+                return;
+            }
+
+            store(buffer_, sizeof(buffer_));
+            buffer_ = fill_ == 0 ? 0 : bits >> (64 - fill_);
+            fill_ = fill_ + count - 64;
+        }
+
+        // writes remaining bits and padding
+        void finish()
+        {
+            store(buffer_, (fill_ + 7) / 8);
+            bytes_.insert(bytes_.end(), padding, 0);
+            buffer_ = 0;
+            fill_ = 0;
+        }
+    };
+
+    class BitReader
+    {
+        const unsigned char* bytes_;
+        std::size_t position_ = 0; // in bits
+
+    public:
+        explicit BitReader(const unsigned char* bytes)
+            : bytes_{bytes}
+        {
+        }
+
+        // next bits - at least 57 are valid
+        std::uint64_t peek() const
+        {
+            std::uint64_t word;
+            std::memcpy(&word, bytes_ + position_ / 8, sizeof(word));
+            return word >> (position_ % 8);
+        }
+
+        void skip(unsigned count)
+        {
+            position_ += count;
+        }
+
+        // count <= 64
+        std::uint64_t read(unsigned count)
+        {
+            if (count > 57)
+            {
+                std::uint64_t low = read(32);
+                return low | read(count - 32) << 32;
+            }
+
+            std::uint64_t bits = peek() & ((std::uint64_t{1} << count) - 1);
+            position_ += count;
+            return bits;
+        }
+
+        std::size_t position() const
+        {
+            return position_;
+        }
+    };
+
+    // integer values that double represents exactly (-0.0 is not one of them - it would not survive a round trip)
+    inline bool is_integer_block(std::span<const double> values)
+    {
+        constexpr double limit = 9007199254740992.0; // 2^53
+        return std::all_of(values.begin(), values.end(), [](double value) {
+            return std::abs(value) <= limit && static_cast<double>(static_cast<std::int64_t>(value)) == value
+                && !(value == 0.0 && std::signbit(value));
+        });
+    }
+
+    inline BlockHeader encode_delta(std::span<const double> values, std::vector<unsigned char>& payload)
+    {
+        auto zigzag = [](std::int64_t delta) { return (static_cast<std::uint64_t>(delta) << 1) ^ static_cast<std::uint64_t>(delta >> 63); };
+
+        std::uint64_t all_bits = 0;
+        for (std::size_t i = 1; i < values.size(); ++i)
+            all_bits |= zigzag(static_cast<std::int64_t>(values[i]) - static_cast<std::int64_t>(values[i - 1]));
+        const auto bit_width = static_cast<unsigned>(std::bit_width(all_bits));
+
+        BitWriter bits{payload};
+        for (std::size_t i = 1; i < values.size(); ++i)
+            bits.write(zigzag(static_cast<std::int64_t>(values[i]) - static_cast<std::int64_t>(values[i - 1])), bit_width);
+        bits.finish();
+
+        BlockHeader header{};
+        header.encoding = Encoding::delta;
+        header.bit_width = static_cast<std::uint8_t>(bit_width);
+        header.first = static_cast<std::uint64_t>(static_cast<std::int64_t>(values.front()));
+        return header;
+    }
+
+    inline BlockHeader encode_xor(std::span<const double> values, std::vector<unsigned char>& payload)
+    {
+        BitWriter bits{payload};
+        std::uint64_t previous = std::bit_cast<std::uint64_t>(values.front());
+        unsigned window_leading = 64, window_trailing = 0; // no window yet
+
+        for (std::size_t i = 1; i < values.size(); ++i)
+        {
+            const auto current = std::bit_cast<std::uint64_t>(values[i]);
+            const std::uint64_t xored = current ^ previous;
+            previous = current;
+
+            if (xored == 0)
+            {
+                bits.write(0b0, 1);
+                continue;
+            }
+
+            const auto leading = static_cast<unsigned>(std::min(std::countl_zero(xored), 63));
+            const auto trailing = static_cast<unsigned>(std::countr_zero(xored));
+            if (window_leading < 64 && leading >= window_leading && trailing >= window_trailing)
+            {
+                bits.write(0b01, 2);
+                bits.write(xored >> window_trailing, 64 - window_leading - window_trailing);
+            }
+            else
+            {
+                const unsigned length = 64 - leading - trailing;
+                bits.write(0b11 | leading << 2 | (length - 1) << 8, 14);
+                bits.write(xored >> trailing, length);
+                window_leading = leading;
+                window_trailing = trailing;
+            }
+        }
+        bits.finish();
+
+        BlockHeader header{};
+        header.encoding = Encoding::xor_float;
+        header.first = std::bit_cast<std::uint64_t>(values.front());
+        return header;
+    }
+
+    // appends payload of values to payload and returns header of the block
+    inline BlockHeader encode_block(std::span<const double> values, std::vector<unsigned char>& payload)
+    {
+        const std::size_t payload_start = payload.size();
+
+        BlockHeader header;
+        if (is_integer_block(values))
+        {
+            header = encode_delta(values, payload);
+        }
+        else
+        {
+            header = encode_xor(values, payload);
+            if (payload.size() - payload_start > values.size() * sizeof(double) + padding)
+            {
+                payload.resize(payload_start);
+                const auto* first = reinterpret_cast<const unsigned char*>(values.data());
+                payload.insert(payload.end(), first, first + values.size() * sizeof(double));
+                payload.insert(payload.end(), padding, 0);
+                header = BlockHeader{};
+                header.encoding = Encoding::raw;
+            }
+        }
+
+        header.count = static_cast<std::uint32_t>(values.size());
+        header.payload_size = payload.size() - payload_start;
+        header.checksum = BinaryFormat::checksum(payload.data() + payload_start, header.payload_size);
+        return header;
+    }
+
+    // decodes block into values (header.count of them), throws for an invalid block
+    inline void decode_block(const BlockHeader& header, const unsigned char* payload, double* values)
+    {
+        if (header.payload_size < padding || BinaryFormat::checksum(payload, header.payload_size) != header.checksum)
+            throw std::runtime_error("Compressed data file is corrupted!!!");
+
+        const std::size_t data_bits = (header.payload_size - padding) * 8;
+
+        switch (header.encoding)
+        {
+        case Encoding::raw:
+            if (header.payload_size != header.count * sizeof(double) + padding)
+                throw std::runtime_error("Compressed data file is corrupted!!!");
+            std::memcpy(values, payload, header.count * sizeof(double));
+            return;
+
+        case Encoding::delta:
+        {
+            const unsigned bit_width = header.bit_width;
+            if (bit_width > 57 || (std::uint64_t{header.count} - 1) * bit_width > data_bits)
+                throw std::runtime_error("Compressed data file is corrupted!!!");
+
+            const std::uint64_t mask = (std::uint64_t{1} << bit_width) - 1;
+            auto value = static_cast<std::int64_t>(header.first);
+            values[0] = static_cast<double>(value);
+            for (std::uint32_t i = 1; i < header.count; ++i)
+            {
+                const std::size_t position = std::size_t{i - 1} * bit_width; // independent of previous values
+                std::uint64_t word;
+                std::memcpy(&word, payload + position / 8, sizeof(word));
+                const std::uint64_t zigzag = (word >> (position % 8)) & mask;
+                value += static_cast<std::int64_t>(zigzag >> 1) ^ -static_cast<std::int64_t>(zigzag & 1);
+                values[i] = static_cast<double>(value);
+            }
+            return;
+        }
+
+        case Encoding::xor_float:
+        {
+            BitReader bits{payload};
+            std::uint64_t value = header.first;
+            unsigned length = 0, trailing = 0;
+            values[0] = std::bit_cast<double>(value);
+            for (std::uint32_t i = 1; i < header.count; ++i)
+            {
+                if (bits.position() > data_bits) // a valid value never starts behind the data
+                    throw std::runtime_error("Compressed data file is corrupted!!!");
+
+                const std::uint64_t control = bits.peek();
+                if ((control & 0b01) == 0)
+                {
+                    bits.skip(1);
+                }
+                else
+                {
+                    if ((control & 0b10) == 0)
+                    {
+                        bits.skip(2);
+                    }
+                    else
+                    {
+                        const auto leading = static_cast<unsigned>(control >> 2 & 63);
+                        length = static_cast<unsigned>(control >> 8 & 63) + 1;
+                        if (leading + length > 64)
+                            throw std::runtime_error("Compressed data file is corrupted!!!");
+                        trailing = 64 - leading - length;
+                        bits.skip(14);
+                    }
+                    value ^= bits.read(length) << trailing;
+                }
+                values[i] = std::bit_cast<double>(value);
+            }
+            if (bits.position() > data_bits)
+                throw std::runtime_error("Compressed data file is corrupted!!!");
+            return;
+        }
+        }
+
+        throw std::runtime_error("Unsupported block encoding!!!");
+    }
+
+    inline FileHeader read_header(const MappedFile& file)
+    {
+        FileHeader header;
+        if (file.size() < sizeof(header))
+            throw std::runtime_error("Invalid compressed data file!!!");
+        std::memcpy(&header, file.data(), sizeof(header));
+
+        if (std::memcmp(header.magic, magic, sizeof(magic)) != 0 || header.version != version || header.block_size == 0
+            || header.block_size > max_block_size)
+            throw std::runtime_error("Invalid compressed data file!!!");
+
+        return header;
+    }
+
+    // Decodes blocks of a mapped file one by one into a buffer of block_size values - consume gets every block
+    template <typename Consumer>
+    std::uint64_t for_each_block(const MappedFile& file, Consumer&& consume)
+    {
+        const auto* bytes = reinterpret_cast<const unsigned char*>(file.data());
+        const FileHeader header = read_header(file);
+        Metrics::add_bytes_read(file.size());
+
+        std::vector<double> values(std::min<std::uint64_t>(header.block_size, header.count));
+        std::size_t offset = sizeof(header);
+        std::uint64_t count = 0;
+        for (std::uint64_t block = 0; block < header.block_count; ++block)
+        {
+            BlockHeader block_header;
+            if (file.size() - offset < sizeof(block_header))
+                throw std::runtime_error("Invalid compressed data file!!!");
+            std::memcpy(&block_header, bytes + offset, sizeof(block_header));
+            offset += sizeof(block_header);
+
+            if (block_header.count == 0 || block_header.count > values.size() || block_header.payload_size > file.size() - offset)
+                throw std::runtime_error("Invalid compressed data file!!!");
+
+            {
+                Metrics::ScopedPhase phase{Metrics::Phase::parse};
+                decode_block(block_header, bytes + offset, values.data());
+            }
+            Metrics::add_values_parsed(block_header.count);
+            offset += block_header.payload_size;
+            count += block_header.count;
+
+            consume(std::span<const double>{values.data(), block_header.count});
+        }
+
+        if (count != header.count || offset != file.size())
+            throw std::runtime_error("Invalid compressed data file!!!");
+
+        return count;
+    }
+
+    inline bool is_compressed_file(const std::string& file_name)
+    {
+        std::ifstream in{file_name, std::ios::binary};
+        char file_magic[sizeof(magic)] = {};
+        in.read(file_magic, sizeof(file_magic));
+        return in && std::memcmp(file_magic, magic, sizeof(magic)) == 0;
+    }
+}
+
+// Writes values to a compressed file as they come - memory used does not depend on the number of values.
+// The header is completed by close() (or the destructor).
+class CompressedWriter
+{
+    std::ofstream out_;
+    std::uint32_t block_size_;
+    Data block_;
+    std::vector<unsigned char> payload_;
+    std::uint64_t count_ = 0;
+    std::uint64_t block_count_ = 0;
+    bool closed_ = false;
+
+    void write_block()
+    {
+        payload_.clear();
+        CompressedFormat::BlockHeader header = CompressedFormat::encode_block(block_, payload_);
+        out_.write(reinterpret_cast<const char*>(&header), sizeof(header));
+        out_.write(reinterpret_cast<const char*>(payload_.data()), payload_.size());
+
+        count_ += block_.size();
+        ++block_count_;
+        block_.clear();
+    }
+
+    void write_header()
+    {
+        using namespace CompressedFormat;
+
+        FileHeader header{};
+        std::memcpy(header.magic, magic, sizeof(magic));
+        header.version = version;
+        header.block_size = block_size_;
+        header.count = count_;
+        header.block_count = block_count_;
+
+        out_.seekp(0);
+        out_.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    }
+
+public:
+    explicit CompressedWriter(const std::string& file_name, std::uint32_t block_size = CompressedFormat::default_block_size)
+        : out_{file_name, std::ios::binary}
+        , block_size_{block_size}
+    {
+        if (block_size == 0 || block_size > CompressedFormat::max_block_size)
+            throw std::invalid_argument("Invalid block size!!!");
+        if (!out_)
+            throw std::runtime_error("File not opened!!!");
+
+        block_.reserve(block_size_);
+        write_header(); // placeholder - count is not known yet
+    }
+
+    CompressedWriter(const CompressedWriter&) = delete;
+    CompressedWriter& operator=(const CompressedWriter&) = delete;
+
+    ~CompressedWriter()
+    {
+        try
+        {
+            close();
+        }
+        catch (...)
+        {
+        }
+    }
+
+    void write(std::span<const double> values)
+    {
+        while (!values.empty())
+        {
+            auto part = values.first(std::min<std::size_t>(values.size(), block_size_ - block_.size()));
+            block_.insert(block_.end(), part.begin(), part.end());
+            values = values.subspan(part.size());
+
+            if (block_.size() == block_size_)
+                write_block();
+        }
+    }
+
+    void close()
+    {
+        if (closed_)
+            return;
+        closed_ = true;
+
+        if (!block_.empty())
+            write_block();
+        write_header();
+        out_.close();
+
+        if (!out_)
+            throw std::runtime_error("File not written!!!");
+    }
+};
+
+inline void compressed_writer(const std::string& file_name, const Data& data)
+{
+    CompressedWriter writer{file_name};
+    writer.write(data);
+    writer.close();
+}
+
+inline Data compressed_reader(const std::string& file_name)
+{
+    MappedFile file{file_name};
+
+    Data data;
+    Metrics::GrowthCounter growth{data};
+    data.reserve(std::min<std::uint64_t>(CompressedFormat::read_header(file).count, file.size() * 64)); // count is not validated yet
+    growth.update();
+    CompressedFormat::for_each_block(file, [&](std::span<const double> values) {
+        data.insert(data.end(), values.begin(), values.end());
+        growth.update();
+    });
+
+    return data;
+}
+
+// DataStreamReader - every decoded block is passed to consumer straight from a cache-sized buffer
+inline void compressed_stream_reader(const std::string& file_name, const ChunkConsumer& consume)
+{
+    MappedFile file{file_name};
+
+    CompressedFormat::for_each_block(file, consume);
+}
+
+#endif // COMPRESSED_FORMAT_HPP
@@ -3,16 +3,31 @@
 
 #include <algorithm>
 #include <cassert>
+#include <cmath>
+#include <concepts>
+#include <cstdint>
 #include <fstream>
 #include <functional>
+#include <future>
 #include <iostream>
 #include <iterator>
+#include <limits>
 #include <list>
+#include <memory>
 #include <numeric>
+#include <optional>
+#include <span>
 #include <stdexcept>
 #include <string>
+#include <string_view>
+#include <thread>
 #include <vector>
 
+#include "accumulator_state.hpp"
+#include "kernels.hpp"
+#include "metrics.hpp"
+#include "zone_map.hpp"
+
 struct StatResult
 {
     std::string description;
@@ -30,10 +45,18 @@ struct StatResult
     }
 };
 
-using Data = std::vector<double>;
+// Element types of loaded data - 32-bit types take half of the memory and bandwidth of double.
+// Statistics widen values to double (and sums of integers to exact 96-bit integers) while accumulating.
+template <typename T>
+concept DataElement = std::same_as<T, std::int32_t> || std::same_as<T, std::int64_t> || std::same_as<T, float> || std::same_as<T, double>;
+
+template <DataElement T>
+using BasicData = std::vector<T>;
+
+using Data = BasicData<double>;
 using Results = std::vector<StatResult>;
 
-std::ostream& operator<<(std::ostream& out, const Results& r)
+inline std::ostream& operator<<(std::ostream& out, const Results& r)
 {
     out << "(";
     for (const auto& item : r)
@@ -127,7 +150,7 @@ namespace LegacyCode
                 throw std::runtime_error("File not opened!!!");
 
             for (const auto& rslt : results_)
-                out << rslt.description << " = " << rslt.value << std::endl;
+                out << rslt.description << " = " << rslt.value << "\n";
         }
     };
 } // namespace LegacyCode
@@ -175,7 +198,7 @@ inline namespace Ver_1
     using DataReader = std::function<Data(const std::string&)>;
     using DataWriter = std::function<void(const std::string&, const Results&)>;
 
-    Data text_reader(const std::string& file_name)
+    inline Data text_reader(const std::string& file_name)
     {
         Data data;
 
@@ -192,7 +215,7 @@ inline namespace Ver_1
         return data;
     }
 
-    auto text_writer = [](const std::string& file_name, const Results& results)
+    inline auto text_writer = [](const std::string& file_name, const Results& results)
     {
         std::ofstream out{file_name};
 
@@ -200,7 +223,7 @@ inline namespace Ver_1
             throw std::runtime_error("File not opened!!!");
 
         for (const auto& rslt : results)
-            out << rslt.description << " = " << rslt.value << std::endl;
+            out << rslt.description << " = " << rslt.value << "\n";
     };
 
     class DataAnalyzer
@@ -278,82 +301,836 @@ namespace Ver_2
     {
     public:
         virtual Results calculate(const Data& data) = 0;
+
+        // identifies statistic together with its parameters - statistics of the same kind give the same results
+        // written to disk by ResultCache, so it has to be stable across compilers and builds
+        virtual std::string kind() const = 0;
+
         virtual ~IStatistics() = default;
     };
 
-    class Avg : public IStatistics
+    // Incremental state of a statistic - data is fed in chunks, so the whole dataset never has to be in memory.
+    // Sums are reduced per chunk (see kernels.hpp), so they can differ in the last bits for different chunk sizes.
+    // States of the same kind can be merged and serialized, so data can be split across threads or machines.
+    class IAccumulator
+    {
+    public:
+        virtual void init() = 0;
+        virtual void update(std::span<const double> values) = 0;
+
+        // Integer data - values are the same integers converted to double. Accumulators that would lose
+        // precision of large integers in double (sums) override it to accumulate integers exactly.
+        virtual void update_integers(std::span<const std::int64_t> integers, std::span<const double> values)
+        {
+            (void)integers;
+            update(values);
+        }
+
+        virtual Results finalize() const = 0;
+        virtual void merge(const IAccumulator& other) = 0;
+        virtual std::string serialize() const = 0;
+        virtual void deserialize(std::string_view state) = 0;
+        virtual ~IAccumulator() = default;
+    };
+
+    template <typename Accumulator>
+    const Accumulator& same_kind(const IAccumulator& other)
+    {
+        auto* accumulator = dynamic_cast<const Accumulator*>(&other);
+        if (!accumulator)
+            throw std::invalid_argument("Accumulator of different kind!!!");
+        return *accumulator;
+    }
+
+    class IStreamingStatistics : public IStatistics
     {
     public:
+        // returns accumulator in initial state
+        virtual std::unique_ptr<IAccumulator> make_accumulator() const = 0;
+
         Results calculate(const Data& data) override
         {
-            Results results;
-            double sum = std::accumulate(data.begin(), data.end(), 0.0);
-            double avg = sum / data.size();
+            auto accumulator = make_accumulator();
+            accumulator->update(data);
+            return accumulator->finalize();
+        }
+    };
+
+    // Exact sum of 64-bit integers - upper and lower 32-bit halves of values are summed separately
+    // and normalized after every update, so it does not overflow for less than 2^31 values per update.
+    class IntegerSum
+    {
+        std::int64_t high_ = 0;
+        std::uint64_t low_ = 0;
+
+    public:
+        void add(std::span<const std::int64_t> values)
+        {
+            for (std::int64_t value : values)
+            {
+                high_ += value >> 32;
+                low_ += static_cast<std::uint64_t>(value) & 0xffffffff;
+            }
+            normalize();
+        }
+
+        void merge(const IntegerSum& other)
+        {
+            high_ += other.high_;
+            low_ += other.low_;
+            normalize();
+        }
+
+        double value() const
+        {
+            return std::ldexp(static_cast<double>(high_), 32) + static_cast<double>(low_);
+        }
+
+        void serialize(StateWriter& state) const
+        {
+            state.write(high_);
+            state.write(low_);
+        }
 
-            StatResult result("Avg", avg);
-            results.push_back(result);
+        void deserialize(StateReader& state)
+        {
+            high_ = state.read<std::int64_t>();
+            low_ = state.read<std::uint64_t>();
+        }
 
-            return results;
+    private:
+        void normalize()
+        {
+            high_ += static_cast<std::int64_t>(low_ >> 32);
+            low_ &= 0xffffffff;
         }
     };
 
-    class MinMax : public IStatistics
+    class Avg : public IStreamingStatistics
     {
     public:
-        Results calculate(const Data& data) override
+        class Accumulator : public IAccumulator
+        {
+            double sum_ = 0.0;
+            IntegerSum integer_sum_;
+            std::size_t count_ = 0;
+
+        public:
+            void init() override
+            {
+                sum_ = 0.0;
+                integer_sum_ = IntegerSum{};
+                count_ = 0;
+            }
+
+            void update(std::span<const double> values) override
+            {
+                sum_ += Kernels::sum(values);
+                count_ += values.size();
+            }
+
+            void update_integers(std::span<const std::int64_t> integers, std::span<const double>) override
+            {
+                integer_sum_.add(integers);
+                count_ += integers.size();
+            }
+
+            Results finalize() const override
+            {
+                return {StatResult("Avg", (sum_ + integer_sum_.value()) / count_)};
+            }
+
+            void merge(const IAccumulator& other) override
+            {
+                const auto& avg = same_kind<Accumulator>(other);
+                sum_ += avg.sum_;
+                integer_sum_.merge(avg.integer_sum_);
+                count_ += avg.count_;
+            }
+
+            std::string serialize() const override
+            {
+                StateWriter state{"Avg"};
+                state.write(sum_);
+                integer_sum_.serialize(state);
+                state.write(static_cast<std::uint64_t>(count_));
+                return state.str();
+            }
+
+            void deserialize(std::string_view bytes) override
+            {
+                StateReader state{bytes, "Avg"};
+                sum_ = state.read<double>();
+                integer_sum_.deserialize(state);
+                count_ = state.read<std::uint64_t>();
+                state.expect_end();
+            }
+        };
+
+        std::unique_ptr<IAccumulator> make_accumulator() const override
         {
-            Results results;
-            double min = *(std::min_element(data.begin(), data.end()));
-            double max = *(std::max_element(data.begin(), data.end()));
+            return std::make_unique<Accumulator>();
+        }
 
-            results.push_back(StatResult("Min", min));
-            results.push_back(StatResult("Max", max));
-            return results;
+        std::string kind() const override
+        {
+            return StateWriter{"Avg"}.str();
         }
     };
 
-    class Sum : public IStatistics
+    class MinMax : public IStreamingStatistics
     {
     public:
-        Results calculate(const Data& data) override
+        class Accumulator : public IAccumulator
+        {
+            double min_ = std::numeric_limits<double>::quiet_NaN();
+            double max_ = std::numeric_limits<double>::quiet_NaN();
+            std::size_t count_ = 0;
+
+            void add(double min, double max, std::size_t count)
+            {
+                if (count == 0)
+                    return;
+
+                if (count_ == 0 || min < min_)
+                    min_ = min;
+                if (count_ == 0 || max > max_)
+                    max_ = max;
+                count_ += count;
+            }
+
+        public:
+            void init() override
+            {
+                min_ = max_ = std::numeric_limits<double>::quiet_NaN();
+                count_ = 0;
+            }
+
+            void update(std::span<const double> values) override
+            {
+                if (values.empty())
+                    return;
+
+                auto [min, max] = Kernels::min_max(values);
+                add(min, max, values.size());
+            }
+
+            Results finalize() const override
+            {
+                return {StatResult("Min", min_), StatResult("Max", max_)};
+            }
+
+            void merge(const IAccumulator& other) override
+            {
+                const auto& min_max = same_kind<Accumulator>(other);
+                add(min_max.min_, min_max.max_, min_max.count_);
+            }
+
+            std::string serialize() const override
+            {
+                StateWriter state{"MinMax"};
+                state.write(min_);
+                state.write(max_);
+                state.write(static_cast<std::uint64_t>(count_));
+                return state.str();
+            }
+
+            void deserialize(std::string_view bytes) override
+            {
+                StateReader state{bytes, "MinMax"};
+                min_ = state.read<double>();
+                max_ = state.read<double>();
+                count_ = state.read<std::uint64_t>();
+                state.expect_end();
+            }
+        };
+
+        std::unique_ptr<IAccumulator> make_accumulator() const override
+        {
+            return std::make_unique<Accumulator>();
+        }
+
+        std::string kind() const override
+        {
+            return StateWriter{"MinMax"}.str();
+        }
+    };
+
+    // K largest (or smallest) values in order - "Top1".."TopK" or "Bottom1".."BottomK", fewer if there is less data.
+    // Candidates better than the current K-th value are buffered; when the buffer holds 2K values it is cut back
+    // to K with nth_element, so every value costs O(1) amortized and the data is never sorted. NaNs are ignored.
+    class TopK : public IStreamingStatistics
+    {
+    public:
+        enum class Order
+        {
+            largest,
+            smallest
+        };
+
+        class Accumulator : public IAccumulator
+        {
+            std::size_t k_;
+            Order order_;
+            std::vector<double> candidates_;
+            double threshold_ = 0.0; // K-th best value after the last prune
+            bool is_full_ = false;
+
+            template <typename Better>
+            void add(std::span<const double> values, Better better)
+            {
+                for (double value : values)
+                {
+                    if (std::isnan(value) || (is_full_ && !better(value, threshold_)))
+                        continue;
+
+                    candidates_.push_back(value);
+                    if (candidates_.size() == 2 * k_)
+                        prune(better);
+                }
+            }
+
+            template <typename Better>
+            void prune(Better better)
+            {
+                std::nth_element(candidates_.begin(), candidates_.begin() + (k_ - 1), candidates_.end(), better);
+                candidates_.resize(k_);
+                threshold_ = candidates_[k_ - 1];
+                is_full_ = true;
+            }
+
+            void add(std::span<const double> values)
+            {
+                if (order_ == Order::largest)
+                    add(values, std::greater<>{});
+                else
+                    add(values, std::less<>{});
+            }
+
+        public:
+            Accumulator(std::size_t k, Order order)
+                : k_{k}
+                , order_{order}
+            {
+            }
+
+            void init() override
+            {
+                candidates_.clear();
+                is_full_ = false;
+            }
+
+            void update(std::span<const double> values) override
+            {
+                if (candidates_.capacity() == 0)
+                    candidates_.reserve(std::min<std::size_t>(2 * k_, values.size()));
+
+                add(values);
+            }
+
+            Results finalize() const override
+            {
+                std::vector<double> values = candidates_;
+                auto sort_best = [&](auto better) {
+                    const std::size_t count = std::min(k_, values.size());
+                    std::partial_sort(values.begin(), values.begin() + count, values.end(), better);
+                    values.resize(count);
+                };
+
+                if (order_ == Order::largest)
+                    sort_best(std::greater<>{});
+                else
+                    sort_best(std::less<>{});
+
+                const std::string prefix = order_ == Order::largest ? "Top" : "Bottom";
+                Results results;
+                results.reserve(values.size());
+                for (std::size_t i = 0; i < values.size(); ++i)
+                    results.push_back(StatResult(prefix + std::to_string(i + 1), values[i]));
+                return results;
+            }
+
+            void merge(const IAccumulator& other) override
+            {
+                const auto& top_k = same_kind<Accumulator>(other);
+                if (top_k.k_ != k_ || top_k.order_ != order_)
+                    throw std::invalid_argument("TopK with different parameters cannot be merged!!!");
+
+                add(top_k.candidates_);
+            }
+
+            std::string serialize() const override
+            {
+                StateWriter state{"TopK"};
+                state.write(static_cast<std::uint64_t>(k_));
+                state.write(static_cast<std::uint8_t>(order_));
+                state.write_array(candidates_.data(), candidates_.size());
+                return state.str();
+            }
+
+            void deserialize(std::string_view bytes) override
+            {
+                StateReader state{bytes, "TopK"};
+                auto k = state.read<std::uint64_t>();
+                auto order = static_cast<Order>(state.read<std::uint8_t>());
+                auto candidates = state.read_array<double>();
+                state.expect_end();
+
+                if (k != k_ || order != order_)
+                    throw std::runtime_error("Invalid accumulator state!!!");
+
+                init();
+                add(candidates);
+            }
+        };
+
+        explicit TopK(std::size_t k = 100, Order order = Order::largest)
+            : k_{k}
+            , order_{order}
+        {
+            if (k_ == 0)
+                throw std::invalid_argument("K must be positive!!!");
+        }
+
+        std::unique_ptr<IAccumulator> make_accumulator() const override
+        {
+            return std::make_unique<Accumulator>(k_, order_);
+        }
+
+        std::string kind() const override
+        {
+            StateWriter kind{"TopK"};
+            kind.write(static_cast<std::uint64_t>(k_));
+            kind.write(static_cast<std::uint8_t>(order_));
+            return kind.str();
+        }
+
+    private:
+        std::size_t k_;
+        Order order_;
+    };
+
+    class Sum : public IStreamingStatistics
+    {
+    public:
+        class Accumulator : public IAccumulator
+        {
+            double sum_ = 0.0;
+            IntegerSum integer_sum_;
+
+        public:
+            void init() override
+            {
+                sum_ = 0.0;
+                integer_sum_ = IntegerSum{};
+            }
+
+            void update(std::span<const double> values) override
+            {
+                sum_ += Kernels::sum(values);
+            }
+
+            void update_integers(std::span<const std::int64_t> integers, std::span<const double>) override
+            {
+                integer_sum_.add(integers);
+            }
+
+            Results finalize() const override
+            {
+                return {StatResult("Sum", sum_ + integer_sum_.value())};
+            }
+
+            void merge(const IAccumulator& other) override
+            {
+                const auto& sum = same_kind<Accumulator>(other);
+                sum_ += sum.sum_;
+                integer_sum_.merge(sum.integer_sum_);
+            }
+
+            std::string serialize() const override
+            {
+                StateWriter state{"Sum"};
+                state.write(sum_);
+                integer_sum_.serialize(state);
+                return state.str();
+            }
+
+            void deserialize(std::string_view bytes) override
+            {
+                StateReader state{bytes, "Sum"};
+                sum_ = state.read<double>();
+                integer_sum_.deserialize(state);
+                state.expect_end();
+            }
+        };
+
+        std::unique_ptr<IAccumulator> make_accumulator() const override
+        {
+            return std::make_unique<Accumulator>();
+        }
+
+        std::string kind() const override
+        {
+            return StateWriter{"Sum"}.str();
+        }
+    };
+
+    // Central moments up to the 4th - one-pass algorithm of Welford generalized to chunks and higher moments (Pebay):
+    // every chunk is reduced with two vectorized passes while it is in cache and then merged into the running state.
+    // Variance, skewness and kurtosis are population statistics, kurtosis is reported as excess kurtosis.
+    class Moments : public IStreamingStatistics
+    {
+    public:
+        enum Result
+        {
+            variance,
+            std_dev,
+            skewness,
+            kurtosis
+        };
+
+        class Accumulator : public IAccumulator
+        {
+            Result result_;
+            std::size_t count_ = 0;
+            double mean_ = 0.0;
+            double m2_ = 0.0; // sums of powers of deviations from mean
+            double m3_ = 0.0;
+            double m4_ = 0.0;
+
+            void add(std::size_t count, double mean, double m2, double m3, double m4)
+            {
+                if (count == 0)
+                    return;
+
+                const double na = static_cast<double>(count_);
+                const double nb = static_cast<double>(count);
+                const double n = na + nb;
+                const double delta = mean - mean_;
+                const double delta_n = delta / n;
+                const double delta_n2 = delta_n * delta_n;
+
+                m4_ += m4 + delta * delta_n * delta_n2 * na * nb * (na * na - na * nb + nb * nb)
+                    + 6.0 * delta_n2 * (na * na * m2 + nb * nb * m2_) + 4.0 * delta_n * (na * m3 - nb * m3_);
+                m3_ += m3 + delta * delta_n2 * na * nb * (na - nb) + 3.0 * delta_n * (na * m2 - nb * m2_);
+                m2_ += m2 + delta * delta_n * na * nb;
+                mean_ += nb * delta_n;
+                count_ += count;
+            }
+
+        public:
+            explicit Accumulator(Result result = variance)
+                : result_{result}
+            {
+            }
+
+            void init() override
+            {
+                count_ = 0;
+                mean_ = m2_ = m3_ = m4_ = 0.0;
+            }
+
+            void update(std::span<const double> values) override
+            {
+                if (values.empty())
+                    return;
+
+                const double mean = Kernels::sum(values) / values.size();
+                auto [m2, m3, m4] = Kernels::central_moments(values, mean);
+
+                add(values.size(), mean, m2, m3, m4);
+            }
+
+            Results finalize() const override
+            {
+                const double n = static_cast<double>(count_);
+
+                switch (result_)
+                {
+                case std_dev:
+                    return {StatResult("StdDev", std::sqrt(m2_ / n))};
+                case skewness:
+                    return {StatResult("Skewness", std::sqrt(n) * m3_ / std::pow(m2_, 1.5))};
+                case kurtosis:
+                    return {StatResult("Kurtosis", n * m4_ / (m2_ * m2_) - 3.0)};
+                default:
+                    return {StatResult("Variance", m2_ / n)};
+                }
+            }
+
+            void merge(const IAccumulator& other) override
+            {
+                const auto& moments = same_kind<Accumulator>(other);
+                add(moments.count_, moments.mean_, moments.m2_, moments.m3_, moments.m4_);
+            }
+
+            std::string serialize() const override
+            {
+                StateWriter state{"Moments"};
+                state.write(static_cast<std::uint64_t>(count_));
+                state.write(mean_);
+                state.write(m2_);
+                state.write(m3_);
+                state.write(m4_);
+                return state.str();
+            }
+
+            void deserialize(std::string_view bytes) override
+            {
+                StateReader state{bytes, "Moments"};
+                count_ = state.read<std::uint64_t>();
+                mean_ = state.read<double>();
+                m2_ = state.read<double>();
+                m3_ = state.read<double>();
+                m4_ = state.read<double>();
+                state.expect_end();
+            }
+        };
+
+        explicit Moments(Result result)
+            : result_{result}
+        {
+        }
+
+        std::unique_ptr<IAccumulator> make_accumulator() const override
+        {
+            return std::make_unique<Accumulator>(result_);
+        }
+
+        std::string kind() const override
+        {
+            StateWriter kind{"Moments"};
+            kind.write(result_);
+            return kind.str();
+        }
+
+    private:
+        Result result_;
+    };
+
+    class Variance : public Moments
+    {
+    public:
+        Variance()
+            : Moments{variance}
+        {
+        }
+    };
+
+    class StdDev : public Moments
+    {
+    public:
+        StdDev()
+            : Moments{std_dev}
         {
-            Results results;
-            double sum = std::accumulate(data.begin(), data.end(), 0.0);
+        }
+    };
 
-            results.push_back(StatResult("Sum", sum));
+    class Skewness : public Moments
+    {
+    public:
+        Skewness()
+            : Moments{skewness}
+        {
+        }
+    };
 
-            return results;
+    class Kurtosis : public Moments
+    {
+    public:
+        Kurtosis()
+            : Moments{kurtosis}
+        {
         }
     };
 
+    using Accumulators = std::vector<std::unique_ptr<IAccumulator>>;
+
+    // nullptr for statistics that cannot be calculated incrementally
+    inline Accumulators make_accumulators(const std::vector<std::shared_ptr<IStatistics>>& stats)
+    {
+        Accumulators accumulators;
+        accumulators.reserve(stats.size());
+        for (const auto& stat : stats)
+        {
+            auto streaming_stat = std::dynamic_pointer_cast<IStreamingStatistics>(stat);
+            accumulators.push_back(streaming_stat ? streaming_stat->make_accumulator() : nullptr);
+        }
+        return accumulators;
+    }
+
+    constexpr std::size_t fused_block_size = 8 * 1024;
+
+    // data is split into blocks that stay in cache and each block is passed to all accumulators before the next one is read
+    inline void update_fused(Accumulators& accumulators, std::span<const double> values)
+    {
+        for (std::size_t offset = 0; offset < values.size(); offset += fused_block_size)
+        {
+            auto block = values.subspan(offset, std::min(fused_block_size, values.size() - offset));
+            for (const auto& accumulator : accumulators)
+                if (accumulator)
+                    accumulator->update(block);
+        }
+    }
+
+    // Other element types are converted block by block - integers are passed also as int64 to update_integers
+    template <DataElement T>
+        requires(!std::same_as<T, double>)
+    void update_fused(Accumulators& accumulators, std::span<const T> values)
+    {
+        std::vector<double> converted(std::min(fused_block_size, values.size()));
+        std::vector<std::int64_t> integers(std::integral<T> ? converted.size() : 0);
+
+        for (std::size_t offset = 0; offset < values.size(); offset += fused_block_size)
+        {
+            auto block = values.subspan(offset, std::min(fused_block_size, values.size() - offset));
+            auto block_values = std::span<double>{converted}.first(block.size());
+            std::copy(block.begin(), block.end(), block_values.begin());
+
+            if constexpr (std::integral<T>)
+            {
+                auto block_integers = std::span<std::int64_t>{integers}.first(block.size());
+                std::copy(block.begin(), block.end(), block_integers.begin());
+
+                for (const auto& accumulator : accumulators)
+                    if (accumulator)
+                        accumulator->update_integers(block_integers, block_values);
+            }
+            else
+            {
+                for (const auto& accumulator : accumulators)
+                    if (accumulator)
+                        accumulator->update(block_values);
+            }
+        }
+    }
+
+    // statistics that cannot be calculated incrementally get a copy of data converted to double
+    template <DataElement T>
+    Results finalize_all(const std::vector<std::shared_ptr<IStatistics>>& stats, const Accumulators& accumulators, const BasicData<T>& data)
+    {
+        std::optional<Data> converted;
+        auto data_of = [&]() -> const Data& {
+            if constexpr (std::same_as<T, double>)
+                return data;
+            else
+                return converted ? *converted : converted.emplace(data.begin(), data.end());
+        };
+
+        Results results;
+        for (std::size_t i = 0; i < stats.size(); ++i)
+        {
+            Results current_results = accumulators[i] ? accumulators[i]->finalize() : stats[i]->calculate(data_of());
+            results.insert(results.end(), current_results.begin(), current_results.end());
+        }
+        return results;
+    }
+
+    // Calculates statistics in one pass over data. Results are returned in the order of stats.
+    template <DataElement T>
+    Results calculate_fused(const std::vector<std::shared_ptr<IStatistics>>& stats, const BasicData<T>& data)
+    {
+        auto accumulators = make_accumulators(stats);
+        update_fused(accumulators, std::span<const T>{data});
+        return finalize_all(stats, accumulators, data);
+    }
+
+    // Each thread reduces its own range of data into partial states, which are merged in order at the end
+    template <DataElement T>
+    Results calculate_parallel(const std::vector<std::shared_ptr<IStatistics>>& stats, const BasicData<T>& data, std::size_t thread_count)
+    {
+        thread_count = std::clamp<std::size_t>(thread_count, 1, data.size() / fused_block_size + 1);
+        const std::size_t chunk_size = (data.size() + thread_count - 1) / thread_count;
+
+        std::vector<std::future<Accumulators>> partial_states;
+        for (std::size_t offset = 0; offset < data.size() || partial_states.empty(); offset += chunk_size)
+        {
+            auto chunk = std::span<const T>{data}.subspan(offset, std::min(chunk_size, data.size() - offset));
+            partial_states.push_back(std::async(std::launch::async, [&stats, chunk] {
+                auto accumulators = make_accumulators(stats);
+                update_fused(accumulators, chunk);
+                return accumulators;
+            }));
+        }
+
+        Accumulators accumulators = partial_states.front().get();
+        for (auto it = std::next(partial_states.begin()); it != partial_states.end(); ++it)
+        {
+            Accumulators partial = it->get();
+            for (std::size_t i = 0; i < accumulators.size(); ++i)
+                if (accumulators[i])
+                    accumulators[i]->merge(*partial[i]);
+        }
+
+        return finalize_all(stats, accumulators, data);
+    }
+
+    // Combines serialized states of a statistic calculated for different shards of data (e.g. on other machines)
+    inline Results merge_states(const IStreamingStatistics& stat, const std::vector<std::string>& states)
+    {
+        auto accumulator = stat.make_accumulator();
+        auto shard = stat.make_accumulator();
+        for (const auto& state : states)
+        {
+            shard->deserialize(state);
+            accumulator->merge(*shard);
+        }
+        return accumulator->finalize();
+    }
+
     namespace Statistics
     {
-        auto avg = std::make_shared<Avg>();
-        auto min_max = std::make_shared<MinMax>();
-        auto sum = std::make_shared<Sum>();
+        inline auto avg = std::make_shared<Avg>();
+        inline auto min_max = std::make_shared<MinMax>();
+        inline auto sum = std::make_shared<Sum>();
+        inline auto variance = std::make_shared<Variance>();
+        inline auto std_dev = std::make_shared<StdDev>();
+        inline auto skewness = std::make_shared<Skewness>();
+        inline auto kurtosis = std::make_shared<Kurtosis>();
+        inline auto top_k = std::make_shared<TopK>(100, TopK::Order::largest);
+        inline auto bottom_k = std::make_shared<TopK>(100, TopK::Order::smallest);
     }
 
-    using DataReader = std::function<Data(const std::string&)>;
+    template <DataElement T>
+    using BasicDataReader = std::function<BasicData<T>(const std::string&)>;
+
+    using DataReader = BasicDataReader<double>;
     using DataWriter = std::function<void(const std::string&, const Results&)>;
 
-    Data text_reader(const std::string& file_name)
+    template <DataElement T>
+    BasicData<T> basic_text_reader(const std::string& file_name)
     {
-        Data data;
+        BasicData<T> data;
 
         std::ifstream fin(file_name.c_str());
         if (!fin)
             throw std::runtime_error("File not opened!!!");
 
-        double d;
-        while (fin >> d)
         {
-            data.push_back(d);
+            Metrics::ScopedPhase phase{Metrics::Phase::parse};
+            Metrics::GrowthCounter growth{data};
+
+            T d;
+            while (fin >> d)
+            {
+                data.push_back(d);
+                growth.update();
+            }
         }
 
+        fin.clear();
+        Metrics::add_bytes_read(static_cast<std::uint64_t>(fin.tellg()));
+        Metrics::add_values_parsed(data.size());
+
         return data;
     }
 
-    auto text_writer = [](const std::string& file_name, const Results& results)
+    inline Data text_reader(const std::string& file_name)
+    {
+        return basic_text_reader<double>(file_name);
+    }
+
+    inline auto text_writer = [](const std::string& file_name, const Results& results)
     {
         std::ofstream out{file_name};
 
@@ -361,20 +1138,33 @@ namespace Ver_2
             throw std::runtime_error("File not opened!!!");
 
         for (const auto& rslt : results)
-            out << rslt.description << " = " << rslt.value << std::endl;
+            out << rslt.description << " = " << rslt.value << "\n";
     };
 
-    class DataAnalyzer
+    // Analyzer of data loaded as elements of type T (e.g. BasicDataAnalyzer<float> for float32 sensor data)
+    template <DataElement T>
+    class BasicDataAnalyzer
     {
-        std::shared_ptr<IStatistics> stat_type_;
-        Data data_;
+        std::vector<std::shared_ptr<IStatistics>> stats_;
+        BasicData<T> data_;
         Results results_;
-        DataReader reader_;
+        BasicDataReader<T> reader_;
         DataWriter writer_;
+        std::string data_file_name_;
+        ZoneMapSource data_source_; // of the file data_ was loaded from
+        std::optional<ZoneMap> zone_map_;
+        std::optional<BinaryFormat::BinaryFile> zone_map_file_; // indexed file, when its data is not loaded
+        Metrics::AnalyzerMetrics metrics_;
+        bool metrics_enabled_ = false;
+
+        Metrics::AnalyzerMetrics* collector()
+        {
+            return metrics_enabled_ ? &metrics_ : nullptr;
+        }
 
     public:
-        DataAnalyzer(std::shared_ptr<IStatistics> stat_type, DataReader reader = text_reader, DataWriter writer = text_writer)
-            : stat_type_{stat_type}
+        BasicDataAnalyzer(std::shared_ptr<IStatistics> stat_type, BasicDataReader<T> reader = basic_text_reader<T>, DataWriter writer = text_writer)
+            : stats_{stat_type}
             , reader_{reader}
             , writer_{writer}
         {
@@ -382,26 +1172,136 @@ namespace Ver_2
 
         void load_data(const std::string& file_name)
         {
+            Metrics::Scope metrics_scope{collector()};
+            Metrics::ScopedPhase phase{Metrics::Phase::load};
+
             data_.clear();
             results_.clear();
+            zone_map_.reset();
+            zone_map_file_.reset();
+            data_file_name_.clear();
 
+            data_source_ = ZoneMap::source_of(file_name);
             data_ = reader_(file_name);
+            data_file_name_ = file_name;
 
             std::cout << "File " << file_name << " has been loaded...\n";
         }
 
         void set_statistics(std::shared_ptr<IStatistics> stat_type)
         {
-            stat_type_ = stat_type;
+            stats_ = {stat_type};
+        }
+
+        // statistics set together are calculated in a single pass over data
+        void set_statistics(std::vector<std::shared_ptr<IStatistics>> stats)
+        {
+            stats_ = std::move(stats);
         }
 
         void calculate()
         {
-            Results current_results = stat_type_->calculate(data_);
+            Metrics::Scope metrics_scope{collector()};
+            Metrics::ScopedPhase phase{Metrics::Phase::calculate};
+
+            Results current_results = calculate_fused(stats_, data_);
+
+            results_.insert(results_.end(), current_results.begin(), current_results.end());
+        }
+
+        void calculate_parallel(std::size_t thread_count = std::thread::hardware_concurrency())
+        {
+            Metrics::Scope metrics_scope{collector()};
+            Metrics::ScopedPhase phase{Metrics::Phase::calculate};
+
+            Results current_results = Ver_2::calculate_parallel(stats_, data_, thread_count);
 
             results_.insert(results_.end(), current_results.begin(), current_results.end());
         }
 
+        // Optional block index of loaded data - range queries then scan only the partial blocks at both ends.
+        // The index is tied to the identity of the loaded file (size, modification time, inode), not to its content.
+        // Zone maps and range queries are available for double data.
+        void build_zone_map(std::uint32_t block_size = ZoneMap::default_block_size)
+            requires std::same_as<T, double>
+        {
+            zone_map_ = ZoneMap::build(data_, block_size, data_source_);
+            zone_map_file_.reset();
+        }
+
+        void save_zone_map(const std::string& file_name) const
+        {
+            if (!zone_map_)
+                throw std::logic_error("Zone map not built!!!");
+
+            zone_map_->save(file_name);
+        }
+
+        void load_zone_map(const std::string& data_file_name)
+            requires std::same_as<T, double>
+        {
+            load_zone_map(data_file_name, ZoneMap::sidecar_name(data_file_name));
+        }
+
+        // Index of data_file_name saved in zone_map_file_name - data does not have to be loaded: range queries
+        // of a binary file that is not loaded read only the partial edge blocks from the mapped file.
+        // A text file must be loaded first.
+        void load_zone_map(const std::string& data_file_name, const std::string& zone_map_file_name)
+            requires std::same_as<T, double>
+        {
+            ZoneMap zone_map = ZoneMap::load(zone_map_file_name);
+
+            std::optional<BinaryFormat::BinaryFile> file;
+            if (data_file_name != data_file_name_ || zone_map.source() != data_source_)
+            {
+                file.emplace(data_file_name);
+                if (file->header().element_type != BinaryFormat::ElementType::float64 || file->header().count != zone_map.count())
+                    throw std::runtime_error("Zone map does not match data!!!");
+            }
+
+            if (!zone_map.matches(data_file_name))
+                throw std::runtime_error("Zone map does not match data!!!");
+
+            zone_map_ = std::move(zone_map);
+            zone_map_file_ = std::move(file);
+        }
+
+        bool has_zone_map() const
+        {
+            return zone_map_.has_value();
+        }
+
+        // count, sum, min and max of values [begin, end) - full scan of the range if there is no zone map
+        ZoneSummary range_summary(std::size_t begin, std::size_t end) const
+            requires std::same_as<T, double>
+        {
+            if (zone_map_file_)
+                return zone_map_->query(*zone_map_file_, begin, end);
+            if (zone_map_)
+                return zone_map_->query(data_, begin, end);
+
+            if (begin > end || end > data_.size())
+                throw std::out_of_range("Invalid range!!!");
+
+            ZoneSummary summary;
+            summary.add(std::span<const double>{data_}.subspan(begin, end - begin));
+            return summary;
+        }
+
+        void calculate_range(std::size_t begin, std::size_t end)
+            requires std::same_as<T, double>
+        {
+            Metrics::Scope metrics_scope{collector()};
+            Metrics::ScopedPhase phase{Metrics::Phase::calculate};
+
+            ZoneSummary summary = range_summary(begin, end);
+
+            results_.push_back(StatResult("Count", static_cast<double>(summary.count)));
+            results_.push_back(StatResult("Sum", summary.sum));
+            results_.push_back(StatResult("Min", summary.min));
+            results_.push_back(StatResult("Max", summary.max));
+        }
+
         const Results& results() const
         {
             return results_;
@@ -409,9 +1309,36 @@ namespace Ver_2
 
         void save_results(const std::string& file_name)
         {
+            Metrics::Scope metrics_scope{collector()};
+            Metrics::ScopedPhase phase{Metrics::Phase::save};
+
             writer_(file_name, results_);
         }
+
+        // Instrumentation is off by default - when enabled, every phase is timed and bytes read,
+        // values parsed and buffers allocated for loaded data are counted
+        void enable_metrics(bool enabled = true)
+        {
+            metrics_enabled_ = enabled;
+        }
+
+        const Metrics::AnalyzerMetrics& metrics() const
+        {
+            return metrics_;
+        }
+
+        void reset_metrics()
+        {
+            metrics_ = Metrics::AnalyzerMetrics{};
+        }
+
+        void save_metrics(const std::string& file_name, Metrics::Format format = Metrics::Format::prometheus) const
+        {
+            Metrics::save(metrics_, file_name, format);
+        }
     };
+
+    using DataAnalyzer = BasicDataAnalyzer<double>;
 }
 
 #endif // SOURCE_HPP
\ No newline at end of file
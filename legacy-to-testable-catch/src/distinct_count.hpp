@@ -0,0 +1,294 @@
+#ifndef DISTINCT_COUNT_HPP
+#define DISTINCT_COUNT_HPP
+
+#include "data_analyzer.hpp"
+
+#include <algorithm>
+#include <bit>
+#include <cmath>
+#include <cstdint>
+#include <stdexcept>
+#include <vector>
+
+// HyperLogLog distinct count estimator (Flajolet et al.) with 2^precision one-byte registers,
+// standard error is about 1.04 / sqrt(2^precision). Up to exact_limit distinct values hashes are kept
+// in a small open-addressing set and the count is exact. Sketches with the same precision can be merged.
+class HyperLogLog
+{
+    std::uint8_t precision_;
+    std::size_t exact_limit_;
+    std::vector<std::uint64_t> exact_; // hash table of distinct hashes, 0 marks an empty slot
+    std::size_t exact_count_ = 0;
+    bool has_zero_hash_ = false;
+    std::vector<std::uint8_t> registers_; // empty while the count is exact
+
+public:
+    static constexpr std::uint8_t min_precision = 4;
+    static constexpr std::uint8_t max_precision = 18;
+    static constexpr std::uint8_t default_precision = 12;
+
+    explicit HyperLogLog(std::uint8_t precision = default_precision)
+        : precision_{std::clamp(precision, min_precision, max_precision)}
+        , exact_limit_{(std::size_t{1} << precision_) / 16}
+        , exact_(2 * exact_limit_)
+    {
+    }
+
+    std::uint8_t precision() const
+    {
+        return precision_;
+    }
+
+    bool is_exact() const
+    {
+        return registers_.empty();
+    }
+
+    // -0.0 and 0.0 are the same value (-0.0 + 0.0 == +0.0)
+    static std::uint64_t hash(double value)
+    {
+        std::uint64_t h = std::bit_cast<std::uint64_t>(value + 0.0);
+        h ^= h >> 33;
+        h *= 0xff51afd7ed558ccdull;
+        h ^= h >> 33;
+        h *= 0xc4ceb9fe1a85ec53ull;
+        h ^= h >> 33;
+        return h;
+    }
+
+    // NaNs are ignored
+    void update(std::span<const double> values)
+    {
+        std::size_t i = 0;
+        for (; i < values.size() && is_exact(); ++i)
+            if (!std::isnan(values[i]))
+                insert_exact(hash(values[i]));
+
+        // one-byte register stores may alias members - registers and precision are kept in locals
+        if (i < values.size())
+        {
+            std::uint8_t* registers = registers_.data();
+            const unsigned precision = precision_;
+            for (; i < values.size(); ++i)
+                if (!std::isnan(values[i]))
+                    insert_register(registers, precision, hash(values[i]));
+        }
+    }
+
+    void merge(const HyperLogLog& other)
+    {
+        if (other.precision_ != precision_)
+            throw std::invalid_argument("HyperLogLog sketches with different precision cannot be merged!!!");
+
+        if (other.is_exact())
+        {
+            other.for_each_exact([this](std::uint64_t h) {
+                if (is_exact())
+                    insert_exact(h);
+                else
+                    insert_register(h);
+            });
+            return;
+        }
+
+        if (is_exact())
+            to_registers();
+        for (std::size_t r = 0; r < registers_.size(); ++r)
+            registers_[r] = std::max(registers_[r], other.registers_[r]);
+    }
+
+    double estimate() const
+    {
+        if (is_exact())
+            return static_cast<double>(exact_count_);
+
+        const double m = static_cast<double>(registers_.size());
+        double inverse_sum = 0.0;
+        std::size_t zero_registers = 0;
+        for (std::uint8_t r : registers_)
+        {
+            inverse_sum += std::ldexp(1.0, -r);
+            zero_registers += r == 0;
+        }
+
+        const double alpha = 0.7213 / (1.0 + 1.079 / m);
+        const double estimate = alpha * m * m / inverse_sum;
+
+        // small range correction - linear counting
+        if (estimate <= 2.5 * m && zero_registers != 0)
+            return m * std::log(m / zero_registers);
+
+        return estimate;
+    }
+
+    void serialize(StateWriter& state) const
+    {
+        state.write(precision_);
+        std::vector<std::uint64_t> hashes;
+        for_each_exact([&](std::uint64_t h) { hashes.push_back(h); });
+        state.write_array(hashes.data(), hashes.size());
+        state.write_array(registers_.data(), registers_.size());
+    }
+
+    void deserialize(StateReader& state)
+    {
+        auto precision = state.read<std::uint8_t>();
+        if (precision < min_precision || precision > max_precision)
+            throw std::runtime_error("Invalid accumulator state!!!");
+
+        *this = HyperLogLog{precision};
+        auto hashes = state.read_array<std::uint64_t>();
+        auto registers = state.read_array<std::uint8_t>();
+        if (!registers.empty() && registers.size() != (std::size_t{1} << precision_))
+            throw std::runtime_error("Invalid accumulator state!!!");
+
+        if (!registers.empty())
+            registers_ = std::move(registers);
+        for (std::uint64_t h : hashes)
+            is_exact() ? insert_exact(h) : insert_register(h);
+    }
+
+private:
+    template <typename F>
+    void for_each_exact(F f) const
+    {
+        if (has_zero_hash_)
+            f(0);
+        for (std::uint64_t h : exact_)
+            if (h != 0)
+                f(h);
+    }
+
+    void insert_exact(std::uint64_t h)
+    {
+        if (h == 0)
+        {
+            exact_count_ += !has_zero_hash_;
+            has_zero_hash_ = true;
+        }
+        else
+        {
+            const std::size_t mask = exact_.size() - 1;
+            std::size_t slot = h & mask;
+            while (exact_[slot] != 0 && exact_[slot] != h)
+                slot = (slot + 1) & mask;
+
+            if (exact_[slot] == h)
+                return;
+
+            exact_[slot] = h;
+            ++exact_count_;
+        }
+
+        if (exact_count_ > exact_limit_)
+            to_registers();
+    }
+
+    static void insert_register(std::uint8_t* registers, unsigned precision, std::uint64_t h)
+    {
+        const std::size_t index = h >> (64 - precision);
+        const auto rank = static_cast<std::uint8_t>(std::countl_zero((h << precision) | (std::uint64_t{1} << (precision - 1))) + 1);
+        // registers rarely grow - conditional store is much cheaper than an unconditional one
+        if (rank > registers[index])
+            registers[index] = rank;
+    }
+
+    void insert_register(std::uint64_t h)
+    {
+        insert_register(registers_.data(), precision_, h);
+    }
+
+    void to_registers()
+    {
+        registers_.assign(std::size_t{1} << precision_, 0);
+        for_each_exact([this](std::uint64_t h) { insert_register(h); });
+
+        exact_ = {};
+        exact_count_ = 0;
+        has_zero_hash_ = false;
+    }
+};
+
+namespace Ver_2
+{
+    // Approximate number of distinct values in a few KB (see HyperLogLog), exact for small counts
+    class DistinctCount : public IStreamingStatistics
+    {
+        std::uint8_t precision_;
+
+    public:
+        class Accumulator : public IAccumulator
+        {
+            HyperLogLog sketch_;
+
+        public:
+            explicit Accumulator(std::uint8_t precision)
+                : sketch_{precision}
+            {
+            }
+
+            void init() override
+            {
+                sketch_ = HyperLogLog{sketch_.precision()};
+            }
+
+            void update(std::span<const double> values) override
+            {
+                sketch_.update(values);
+            }
+
+            Results finalize() const override
+            {
+                return {StatResult("DistinctCount", std::round(sketch_.estimate()))};
+            }
+
+            void merge(const IAccumulator& other) override
+            {
+                sketch_.merge(same_kind<Accumulator>(other).sketch_);
+            }
+
+            std::string serialize() const override
+            {
+                StateWriter state{"DistinctCount"};
+                sketch_.serialize(state);
+                return state.str();
+            }
+
+            void deserialize(std::string_view bytes) override
+            {
+                StateReader state{bytes, "DistinctCount"};
+                sketch_.deserialize(state);
+                state.expect_end();
+            }
+
+            const HyperLogLog& sketch() const
+            {
+                return sketch_;
+            }
+        };
+
+        explicit DistinctCount(std::uint8_t precision = HyperLogLog::default_precision)
+            : precision_{precision}
+        {
+        }
+
+        std::unique_ptr<IAccumulator> make_accumulator() const override
+        {
+            return std::make_unique<Accumulator>(precision_);
+        }
+
+        std::string kind() const override
+        {
+            StateWriter kind{"DistinctCount"};
+            kind.write(precision_);
+            return kind.str();
+        }
+    };
+
+    namespace Statistics
+    {
+        inline auto distinct_count = std::make_shared<DistinctCount>();
+    }
+}
+
+#endif // DISTINCT_COUNT_HPP
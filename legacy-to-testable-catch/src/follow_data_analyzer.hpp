@@ -0,0 +1,249 @@
+#ifndef FOLLOW_DATA_ANALYZER_HPP
+#define FOLLOW_DATA_ANALYZER_HPP
+
+#include "data_analyzer.hpp"
+#include "mmap_reader.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <fstream>
+#include <functional>
+#include <memory>
+#include <stdexcept>
+#include <stop_token>
+#include <string>
+#include <thread>
+#include <vector>
+
+#ifndef _WIN32
+#include <sys/stat.h>
+#endif
+
+#ifdef __linux__
+#include <poll.h>
+#include <sys/inotify.h>
+#include <unistd.h>
+#endif
+
+namespace Ver_2
+{
+    // Follows a data file that is being appended to (like tail -f): every refresh parses only the bytes appended
+    // since the previous one and updates accumulators, so results are always those of the whole file.
+    // A number is parsed once it is followed by a separator - the last one can still be written by the producer
+    // (finish() parses it when the file is complete). A file shorter than the followed offset or replaced by another one
+    // (rotated - its device and inode changed) is followed from the start.
+    // Like text_reader it stops at the first token that is not a number.
+    class FollowDataAnalyzer
+    {
+        struct FileId
+        {
+            std::uint64_t device = 0;
+            std::uint64_t inode = 0;
+
+            bool operator==(const FileId&) const = default;
+        };
+
+        std::string file_name_;
+        Accumulators accumulators_;
+        Results results_;
+        DataWriter writer_;
+        std::size_t block_size_;
+
+        std::uint64_t offset_ = 0; // bytes read from file, including pending_
+        std::string pending_;      // unparsed tail - possibly a partial number
+        std::uint64_t value_count_ = 0;
+        bool stopped_ = false; // invalid token found
+        FileId file_id_;       // of the file read so far
+        Data values_;
+
+        // identity of the file currently behind file_name_ (not known on Windows)
+        FileId file_id() const
+        {
+#ifndef _WIN32
+            struct stat info;
+            if (::stat(file_name_.c_str(), &info) == 0)
+                return {static_cast<std::uint64_t>(info.st_dev), static_cast<std::uint64_t>(info.st_ino)};
+#endif
+            return {};
+        }
+
+        void reset()
+        {
+            for (auto& accumulator : accumulators_)
+                accumulator->init();
+            offset_ = value_count_ = 0;
+            pending_.clear();
+            stopped_ = false;
+        }
+
+        // parses pending text up to parse_end
+        bool parse(std::size_t parse_end)
+        {
+            values_.clear();
+            const std::size_t consumed = parse_numbers(std::string_view{pending_}.substr(0, parse_end), values_);
+
+            if (consumed < parse_end)
+            {
+                stopped_ = true;
+                pending_.clear();
+            }
+            else
+            {
+                pending_.erase(0, parse_end);
+            }
+
+            update_fused(accumulators_, values_);
+            value_count_ += values_.size();
+            return !values_.empty();
+        }
+
+        void update_results()
+        {
+            results_.clear();
+            for (const auto& accumulator : accumulators_)
+            {
+                Results current_results = accumulator->finalize();
+                results_.insert(results_.end(), current_results.begin(), current_results.end());
+            }
+        }
+
+    public:
+        static constexpr std::size_t default_block_size = 1024 * 1024;
+
+        FollowDataAnalyzer(std::string file_name, std::vector<std::shared_ptr<IStreamingStatistics>> stats, DataWriter writer = text_writer,
+            std::size_t block_size = default_block_size)
+            : file_name_{std::move(file_name)}
+            , writer_{writer}
+            , block_size_{std::max<std::size_t>(block_size, 1)}
+        {
+            for (const auto& stat : stats)
+                accumulators_.push_back(stat->make_accumulator());
+            update_results();
+        }
+
+        // parses numbers appended since the last refresh, returns true if there were any
+        bool refresh()
+        {
+            std::ifstream fin;
+            FileId id;
+            do // opened again if the file was replaced meanwhile, so id is that of the opened file
+            {
+                id = file_id();
+                fin = std::ifstream(file_name_, std::ios::binary | std::ios::ate);
+                if (!fin)
+                    throw std::runtime_error("File not opened!!!");
+            } while (file_id() != id);
+
+            if (id != file_id_ || static_cast<std::uint64_t>(fin.tellg()) < offset_) // replaced or truncated
+            {
+                reset();
+                update_results();
+                file_id_ = id;
+            }
+
+            if (stopped_)
+                return false;
+
+            fin.seekg(offset_);
+            std::string block(block_size_, '\0');
+            bool updated = false;
+            while (!stopped_)
+            {
+                fin.read(block.data(), block.size());
+                const auto bytes_read = static_cast<std::size_t>(fin.gcount());
+                if (bytes_read == 0)
+                    break;
+
+                offset_ += bytes_read;
+                pending_.append(block, 0, bytes_read);
+
+                auto last_separator = std::find_if(pending_.rbegin(), pending_.rend(), is_number_separator);
+                updated |= parse(static_cast<std::size_t>(pending_.rend() - last_separator));
+            }
+
+            if (updated)
+                update_results();
+            return updated;
+        }
+
+        // parses the rest of the file including the last number not followed by a separator
+        void finish()
+        {
+            refresh();
+            if (!stopped_ && parse(pending_.size()))
+                update_results();
+        }
+
+        // Refreshes until stop is requested - woken by inotify on Linux, otherwise (and additionally) polled.
+        // on_update is called with new results after every refresh that parsed new values.
+        void follow(std::stop_token stop, std::chrono::milliseconds poll_interval = std::chrono::milliseconds{100},
+            const std::function<void(const Results&)>& on_update = {})
+        {
+#ifdef __linux__
+            struct Watch
+            {
+                int fd = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+
+                ~Watch()
+                {
+                    if (fd >= 0)
+                        close(fd);
+                }
+            } watch;
+
+            if (watch.fd >= 0)
+                inotify_add_watch(watch.fd, file_name_.c_str(), IN_MODIFY | IN_CLOSE_WRITE | IN_ATTRIB);
+#endif
+
+            while (!stop.stop_requested())
+            {
+                if (refresh() && on_update)
+                    on_update(results_);
+
+#ifdef __linux__
+                if (watch.fd >= 0)
+                {
+                    pollfd event{watch.fd, POLLIN, 0};
+                    if (poll(&event, 1, static_cast<int>(poll_interval.count())) > 0)
+                    {
+                        char buffer[4096];
+                        while (read(watch.fd, buffer, sizeof(buffer)) > 0)
+                            ;
+                    }
+                    continue;
+                }
+#endif
+                std::this_thread::sleep_for(poll_interval);
+            }
+        }
+
+        const std::string& file_name() const
+        {
+            return file_name_;
+        }
+
+        // bytes of the file consumed so far (a partial number at the end is not consumed yet)
+        std::uint64_t offset() const
+        {
+            return offset_ - pending_.size();
+        }
+
+        std::uint64_t value_count() const
+        {
+            return value_count_;
+        }
+
+        const Results& results() const
+        {
+            return results_;
+        }
+
+        void save_results(const std::string& file_name)
+        {
+            writer_(file_name, results_);
+        }
+    };
+}
+
+#endif // FOLLOW_DATA_ANALYZER_HPP
@@ -0,0 +1,207 @@
+#ifndef HISTOGRAM_HPP
+#define HISTOGRAM_HPP
+
+#include "data_analyzer.hpp"
+
+#include <algorithm>
+#include <charconv>
+#include <cmath>
+#include <cstdint>
+#include <functional>
+#include <limits>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+namespace Ver_2
+{
+    // Counts of values in bins [edges[i], edges[i + 1]) plus underflow (values below the first edge and NaNs)
+    // and overflow (values at or above the last edge). Fixed-width bins are counted with SIMD kernel,
+    // explicit edges with binary search. Results: "Underflow", one "Bin[low, high)" per bin, "Overflow".
+    class Histogram : public IStreamingStatistics
+    {
+        std::vector<double> edges_;
+        bool fixed_width_;
+
+        // Tolerance of Kernels::histogram - floor of (value - low) * scale misses the bin only around an edge, where it can be
+        // as far below i as that of edges[i] or as far above i as that of the double before edges[i]
+        static double kernel_tolerance(const std::vector<double>& edges, double scale)
+        {
+            double tolerance = 0.0;
+            for (std::size_t i = 0; i < edges.size(); ++i)
+            {
+                const double at_edge = (edges[i] - edges.front()) * scale;
+                const double below_edge = (std::nextafter(edges[i], -std::numeric_limits<double>::infinity()) - edges.front()) * scale;
+                tolerance = std::max({tolerance, static_cast<double>(i) - at_edge, below_edge - static_cast<double>(i)});
+            }
+            return tolerance;
+        }
+
+    public:
+        class Accumulator : public IAccumulator
+        {
+            std::vector<double> edges_;
+            bool fixed_width_;
+            double scale_;
+            std::vector<double> bounds_; // edges with a NaN on both sides, for Kernels::histogram
+            double tolerance_ = 0.0;
+            Kernels::HistogramBins bins_; // local bins of the thread that owns the accumulator
+
+        public:
+            Accumulator(std::vector<double> edges, bool fixed_width)
+                : edges_{std::move(edges)}
+                , fixed_width_{fixed_width}
+                , scale_{(edges_.size() - 1) / (edges_.back() - edges_.front())}
+                , bins_{edges_.size() + 1}
+            {
+                if (fixed_width_)
+                {
+                    bounds_.push_back(std::numeric_limits<double>::quiet_NaN());
+                    bounds_.insert(bounds_.end(), edges_.begin(), edges_.end());
+                    bounds_.push_back(std::numeric_limits<double>::quiet_NaN());
+                    tolerance_ = kernel_tolerance(edges_, scale_);
+                }
+            }
+
+            void init() override
+            {
+                bins_.clear();
+            }
+
+            void update(std::span<const double> values) override
+            {
+                if (fixed_width_)
+                {
+                    Kernels::histogram(values, Kernels::HistogramEdges{edges_.front(), scale_, bounds_, tolerance_}, bins_);
+                    return;
+                }
+
+                for (double value : values)
+                {
+                    if (std::isnan(value))
+                        bins_.add(0);
+                    else
+                        bins_.add(std::upper_bound(edges_.begin(), edges_.end(), value) - edges_.begin());
+                }
+            }
+
+            Results finalize() const override
+            {
+                const std::vector<std::uint64_t> counts = bins_.counts();
+
+                Results results;
+                results.push_back(StatResult("Underflow", static_cast<double>(counts.front())));
+                for (std::size_t i = 0; i + 1 < edges_.size(); ++i)
+                    results.push_back(StatResult(description(edges_[i], edges_[i + 1]), static_cast<double>(counts[i + 1])));
+                results.push_back(StatResult("Overflow", static_cast<double>(counts.back())));
+                return results;
+            }
+
+            void merge(const IAccumulator& other) override
+            {
+                const auto& other_histogram = same_kind<Accumulator>(other);
+                if (other_histogram.edges_ != edges_)
+                    throw std::invalid_argument("Histograms with different bins cannot be merged!!!");
+
+                bins_.merge(other_histogram.bins_);
+            }
+
+            std::string serialize() const override
+            {
+                StateWriter state{"Histogram"};
+                state.write_array(edges_.data(), edges_.size());
+                const std::vector<std::uint64_t> counts = bins_.counts();
+                state.write_array(counts.data(), counts.size());
+                return state.str();
+            }
+
+            void deserialize(std::string_view bytes) override
+            {
+                StateReader state{bytes, "Histogram"};
+                auto edges = state.read_array<double>();
+                auto counts = state.read_array<std::uint64_t>();
+                state.expect_end();
+
+                if (edges != edges_ || counts.size() != bins_.size())
+                    throw std::runtime_error("Invalid accumulator state!!!");
+                bins_.clear();
+                for (std::size_t i = 0; i < counts.size(); ++i)
+                    bins_.add(i, counts[i]);
+            }
+
+            std::vector<std::uint64_t> counts() const
+            {
+                return bins_.counts();
+            }
+        };
+
+        // bin_count bins of equal width in [low, high)
+        Histogram(double low, double high, std::size_t bin_count)
+            : fixed_width_{true}
+        {
+            // bins of kernels are int32_t, including underflow and overflow
+            if (bin_count > static_cast<std::size_t>(std::numeric_limits<std::int32_t>::max()) - 2)
+                throw std::invalid_argument("Too many histogram bins!!!");
+            if (!(low < high) || !std::isfinite(high - low) || bin_count == 0)
+                throw std::invalid_argument("Invalid histogram range!!!");
+
+            const double width = (high - low) / bin_count;
+            edges_.reserve(bin_count + 1);
+            for (std::size_t i = 0; i < bin_count; ++i)
+                edges_.push_back(low + i * width);
+            edges_.push_back(high);
+
+            // kernel moves bins by at most one to match edges - not enough for bins narrower than the rounding of edges
+            const double scale = bin_count / (high - low);
+            if (!std::isfinite(scale) || std::adjacent_find(edges_.begin(), edges_.end(), std::greater_equal<>{}) != edges_.end()
+                || !(kernel_tolerance(edges_, scale) < 1.0))
+                throw std::invalid_argument("Invalid histogram range!!!");
+        }
+
+        explicit Histogram(std::vector<double> edges)
+            : edges_{std::move(edges)}
+            , fixed_width_{false}
+        {
+            if (edges_.size() < 2 || std::adjacent_find(edges_.begin(), edges_.end(), std::greater_equal<>{}) != edges_.end()
+                || std::any_of(edges_.begin(), edges_.end(), [](double edge) { return !std::isfinite(edge); }))
+                throw std::invalid_argument("Histogram edges must be finite and increasing!!!");
+        }
+
+        const std::vector<double>& edges() const
+        {
+            return edges_;
+        }
+
+        std::unique_ptr<IAccumulator> make_accumulator() const override
+        {
+            return std::make_unique<Accumulator>(edges_, fixed_width_);
+        }
+
+        std::string kind() const override
+        {
+            StateWriter kind{"Histogram"};
+            kind.write(fixed_width_);
+            kind.write_array(edges_.data(), edges_.size());
+            return kind.str();
+        }
+
+        // 0, 2.5 -> "Bin[0, 2.5)"
+        static std::string description(double low, double high)
+        {
+            char buffer[64];
+            char* ptr = std::to_chars(std::begin(buffer), std::end(buffer), low).ptr;
+            *ptr++ = ',';
+            *ptr++ = ' ';
+            ptr = std::to_chars(ptr, std::end(buffer), high).ptr;
+            return "Bin[" + std::string(buffer, ptr) + ")";
+        }
+    };
+
+    namespace Statistics
+    {
+        // 10 bins of width 10 in [0, 100)
+        inline auto histogram = std::make_shared<Histogram>(0.0, 100.0, 10);
+    }
+}
+
+#endif // HISTOGRAM_HPP
@@ -0,0 +1,671 @@
+#include "kernels.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <iterator>
+#include <vector>
+
+#if defined(__x86_64__) || defined(_M_X64) || defined(__i386__) || defined(_M_IX86)
+#define KERNELS_X86 1
+#include <immintrin.h>
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
+#endif
+
+#if defined(KERNELS_X86) && (defined(__GNUC__) || defined(__clang__))
+#define KERNELS_TARGET(isa) __attribute__((target(isa)))
+#else
+#define KERNELS_TARGET(isa)
+#endif
+
+namespace Kernels
+{
+    namespace
+    {
+        constexpr double min_op(double value, double lane)
+        {
+            return value < lane ? value : lane;
+        }
+
+        constexpr double max_op(double value, double lane)
+        {
+            return value > lane ? value : lane;
+        }
+
+        // adds values left after the vectorized loop (at most lane_count - 1) and combines lanes
+        double finish_sum(double (&lanes)[lane_count], std::span<const double> tail)
+        {
+            for (std::size_t i = 0; i < tail.size(); ++i)
+                lanes[i] = lanes[i] + tail[i];
+
+            for (std::size_t w = lane_count / 2; w > 0; w /= 2)
+                for (std::size_t j = 0; j < w; ++j)
+                    lanes[j] = lanes[j + w] + lanes[j];
+
+            return lanes[0];
+        }
+
+        MinMaxResult finish_min_max(double (&min_lanes)[lane_count], double (&max_lanes)[lane_count], std::span<const double> tail)
+        {
+            for (std::size_t i = 0; i < tail.size(); ++i)
+            {
+                min_lanes[i] = min_op(tail[i], min_lanes[i]);
+                max_lanes[i] = max_op(tail[i], max_lanes[i]);
+            }
+
+            for (std::size_t w = lane_count / 2; w > 0; w /= 2)
+                for (std::size_t j = 0; j < w; ++j)
+                {
+                    min_lanes[j] = min_op(min_lanes[j + w], min_lanes[j]);
+                    max_lanes[j] = max_op(max_lanes[j + w], max_lanes[j]);
+                }
+
+            return {min_lanes[0], max_lanes[0]};
+        }
+
+        CentralMoments finish_central_moments(double (&m2)[lane_count], double (&m3)[lane_count], double (&m4)[lane_count],
+            std::span<const double> tail, double mean)
+        {
+            for (std::size_t i = 0; i < tail.size(); ++i)
+            {
+                const double d = tail[i] - mean;
+                const double d2 = d * d;
+                m2[i] = m2[i] + d2;
+                m3[i] = m3[i] + d2 * d;
+                m4[i] = m4[i] + d2 * d2;
+            }
+
+            for (std::size_t w = lane_count / 2; w > 0; w /= 2)
+                for (std::size_t j = 0; j < w; ++j)
+                {
+                    m2[j] = m2[j + w] + m2[j];
+                    m3[j] = m3[j + w] + m3[j];
+                    m4[j] = m4[j + w] + m4[j];
+                }
+
+            return {m2[0], m3[0], m4[0]};
+        }
+
+        std::size_t vectorized_size(std::span<const double> values)
+        {
+            return values.size() - values.size() % lane_count;
+        }
+
+        double sum_scalar(std::span<const double> values)
+        {
+            double lanes[lane_count] = {};
+            const std::size_t n = vectorized_size(values);
+
+            for (std::size_t i = 0; i < n; i += lane_count)
+                for (std::size_t j = 0; j < lane_count; ++j)
+                    lanes[j] = lanes[j] + values[i + j];
+
+            return finish_sum(lanes, values.subspan(n));
+        }
+
+        MinMaxResult min_max_scalar(std::span<const double> values)
+        {
+            double min_lanes[lane_count];
+            double max_lanes[lane_count];
+            std::fill(std::begin(min_lanes), std::end(min_lanes), values[0]);
+            std::fill(std::begin(max_lanes), std::end(max_lanes), values[0]);
+            const std::size_t n = vectorized_size(values);
+
+            for (std::size_t i = 0; i < n; i += lane_count)
+                for (std::size_t j = 0; j < lane_count; ++j)
+                {
+                    min_lanes[j] = min_op(values[i + j], min_lanes[j]);
+                    max_lanes[j] = max_op(values[i + j], max_lanes[j]);
+                }
+
+            return finish_min_max(min_lanes, max_lanes, values.subspan(n));
+        }
+
+        CentralMoments central_moments_scalar(std::span<const double> values, double mean)
+        {
+            double m2[lane_count] = {};
+            double m3[lane_count] = {};
+            double m4[lane_count] = {};
+            const std::size_t n = vectorized_size(values);
+
+            for (std::size_t i = 0; i < n; i += lane_count)
+                for (std::size_t j = 0; j < lane_count; ++j)
+                {
+                    const double d = values[i + j] - mean;
+                    const double d2 = d * d;
+                    m2[j] = m2[j] + d2;
+                    m3[j] = m3[j] + d2 * d;
+                    m4[j] = m4[j] + d2 * d2;
+                }
+
+            return finish_central_moments(m2, m3, m4, values.subspan(n), mean);
+        }
+
+        // bin is checked against bounds for every value - two loads are cheaper than the test of tolerance
+        std::int32_t histogram_bin(double value, const HistogramEdges& edges, double max_bin)
+        {
+            double t = (value - edges.low) * edges.scale;
+            t = t > -1.0 ? t : -1.0;
+            t = t < max_bin ? t : max_bin;
+            const std::int32_t bin = static_cast<std::int32_t>(std::floor(t)) + 1;
+            return bin + (value >= edges.bounds[bin + 1]) - (value < edges.bounds[bin]);
+        }
+
+        void histogram_tail(std::span<const double> tail, const HistogramEdges& edges, HistogramBins& bins)
+        {
+            const double max_bin = static_cast<double>(bins.size() - 2);
+            for (double value : tail)
+                bins.add(histogram_bin(value, edges, max_bin));
+        }
+
+        void histogram_scalar(std::span<const double> values, const HistogramEdges& edges, HistogramBins& local)
+        {
+            const double max_bin = static_cast<double>(local.size() - 2);
+            const std::size_t n = vectorized_size(values);
+
+            std::int32_t bins[lane_count];
+            for (std::size_t i = 0; i < n; i += lane_count)
+            {
+                for (std::size_t j = 0; j < lane_count; ++j)
+                    bins[j] = histogram_bin(values[i + j], edges, max_bin);
+                local.add_lanes(bins);
+            }
+
+            histogram_tail(values.subspan(n), edges, local);
+        }
+
+#ifdef KERNELS_X86
+        // _mm*_min_pd(a, b) returns a < b ? a : b and _mm*_max_pd(a, b) returns a > b ? a : b,
+        // so passing (value, lane) gives exactly min_op/max_op
+
+        KERNELS_TARGET("sse2")
+        double sum_sse2(std::span<const double> values)
+        {
+            constexpr std::size_t regs = lane_count / 2;
+            __m128d acc[regs];
+            for (auto& a : acc)
+                a = _mm_setzero_pd();
+
+            const double* p = values.data();
+            const std::size_t n = vectorized_size(values);
+            for (std::size_t i = 0; i < n; i += lane_count)
+                for (std::size_t r = 0; r < regs; ++r)
+                    acc[r] = _mm_add_pd(acc[r], _mm_loadu_pd(p + i + 2 * r));
+
+            double lanes[lane_count];
+            for (std::size_t r = 0; r < regs; ++r)
+                _mm_storeu_pd(lanes + 2 * r, acc[r]);
+
+            return finish_sum(lanes, values.subspan(n));
+        }
+
+        KERNELS_TARGET("sse2")
+        MinMaxResult min_max_sse2(std::span<const double> values)
+        {
+            constexpr std::size_t regs = lane_count / 2;
+            __m128d min_acc[regs];
+            __m128d max_acc[regs];
+            for (std::size_t r = 0; r < regs; ++r)
+                min_acc[r] = max_acc[r] = _mm_set1_pd(values[0]);
+
+            const double* p = values.data();
+            const std::size_t n = vectorized_size(values);
+            for (std::size_t i = 0; i < n; i += lane_count)
+                for (std::size_t r = 0; r < regs; ++r)
+                {
+                    __m128d v = _mm_loadu_pd(p + i + 2 * r);
+                    min_acc[r] = _mm_min_pd(v, min_acc[r]);
+                    max_acc[r] = _mm_max_pd(v, max_acc[r]);
+                }
+
+            double min_lanes[lane_count];
+            double max_lanes[lane_count];
+            for (std::size_t r = 0; r < regs; ++r)
+            {
+                _mm_storeu_pd(min_lanes + 2 * r, min_acc[r]);
+                _mm_storeu_pd(max_lanes + 2 * r, max_acc[r]);
+            }
+
+            return finish_min_max(min_lanes, max_lanes, values.subspan(n));
+        }
+
+        KERNELS_TARGET("sse2")
+        CentralMoments central_moments_sse2(std::span<const double> values, double mean)
+        {
+            constexpr std::size_t regs = lane_count / 2;
+            __m128d m2[regs];
+            __m128d m3[regs];
+            __m128d m4[regs];
+            for (std::size_t r = 0; r < regs; ++r)
+                m2[r] = m3[r] = m4[r] = _mm_setzero_pd();
+
+            const __m128d mean_v = _mm_set1_pd(mean);
+            const double* p = values.data();
+            const std::size_t n = vectorized_size(values);
+            for (std::size_t i = 0; i < n; i += lane_count)
+                for (std::size_t r = 0; r < regs; ++r)
+                {
+                    __m128d d = _mm_sub_pd(_mm_loadu_pd(p + i + 2 * r), mean_v);
+                    __m128d d2 = _mm_mul_pd(d, d);
+                    m2[r] = _mm_add_pd(m2[r], d2);
+                    m3[r] = _mm_add_pd(m3[r], _mm_mul_pd(d2, d));
+                    m4[r] = _mm_add_pd(m4[r], _mm_mul_pd(d2, d2));
+                }
+
+            double m2_lanes[lane_count];
+            double m3_lanes[lane_count];
+            double m4_lanes[lane_count];
+            for (std::size_t r = 0; r < regs; ++r)
+            {
+                _mm_storeu_pd(m2_lanes + 2 * r, m2[r]);
+                _mm_storeu_pd(m3_lanes + 2 * r, m3[r]);
+                _mm_storeu_pd(m4_lanes + 2 * r, m4[r]);
+            }
+
+            return finish_central_moments(m2_lanes, m3_lanes, m4_lanes, values.subspan(n), mean);
+        }
+
+        KERNELS_TARGET("avx2")
+        double sum_avx2(std::span<const double> values)
+        {
+            constexpr std::size_t regs = lane_count / 4;
+            __m256d acc[regs];
+            for (auto& a : acc)
+                a = _mm256_setzero_pd();
+
+            const double* p = values.data();
+            const std::size_t n = vectorized_size(values);
+            for (std::size_t i = 0; i < n; i += lane_count)
+                for (std::size_t r = 0; r < regs; ++r)
+                    acc[r] = _mm256_add_pd(acc[r], _mm256_loadu_pd(p + i + 4 * r));
+
+            double lanes[lane_count];
+            for (std::size_t r = 0; r < regs; ++r)
+                _mm256_storeu_pd(lanes + 4 * r, acc[r]);
+
+            return finish_sum(lanes, values.subspan(n));
+        }
+
+        KERNELS_TARGET("avx2")
+        MinMaxResult min_max_avx2(std::span<const double> values)
+        {
+            constexpr std::size_t regs = lane_count / 4;
+            __m256d min_acc[regs];
+            __m256d max_acc[regs];
+            for (std::size_t r = 0; r < regs; ++r)
+                min_acc[r] = max_acc[r] = _mm256_set1_pd(values[0]);
+
+            const double* p = values.data();
+            const std::size_t n = vectorized_size(values);
+            for (std::size_t i = 0; i < n; i += lane_count)
+                for (std::size_t r = 0; r < regs; ++r)
+                {
+                    __m256d v = _mm256_loadu_pd(p + i + 4 * r);
+                    min_acc[r] = _mm256_min_pd(v, min_acc[r]);
+                    max_acc[r] = _mm256_max_pd(v, max_acc[r]);
+                }
+
+            double min_lanes[lane_count];
+            double max_lanes[lane_count];
+            for (std::size_t r = 0; r < regs; ++r)
+            {
+                _mm256_storeu_pd(min_lanes + 4 * r, min_acc[r]);
+                _mm256_storeu_pd(max_lanes + 4 * r, max_acc[r]);
+            }
+
+            return finish_min_max(min_lanes, max_lanes, values.subspan(n));
+        }
+
+        KERNELS_TARGET("avx2")
+        CentralMoments central_moments_avx2(std::span<const double> values, double mean)
+        {
+            constexpr std::size_t regs = lane_count / 4;
+            __m256d m2[regs];
+            __m256d m3[regs];
+            __m256d m4[regs];
+            for (std::size_t r = 0; r < regs; ++r)
+                m2[r] = m3[r] = m4[r] = _mm256_setzero_pd();
+
+            const __m256d mean_v = _mm256_set1_pd(mean);
+            const double* p = values.data();
+            const std::size_t n = vectorized_size(values);
+            for (std::size_t i = 0; i < n; i += lane_count)
+                for (std::size_t r = 0; r < regs; ++r)
+                {
+                    __m256d d = _mm256_sub_pd(_mm256_loadu_pd(p + i + 4 * r), mean_v);
+                    __m256d d2 = _mm256_mul_pd(d, d);
+                    m2[r] = _mm256_add_pd(m2[r], d2);
+                    m3[r] = _mm256_add_pd(m3[r], _mm256_mul_pd(d2, d));
+                    m4[r] = _mm256_add_pd(m4[r], _mm256_mul_pd(d2, d2));
+                }
+
+            double m2_lanes[lane_count];
+            double m3_lanes[lane_count];
+            double m4_lanes[lane_count];
+            for (std::size_t r = 0; r < regs; ++r)
+            {
+                _mm256_storeu_pd(m2_lanes + 4 * r, m2[r]);
+                _mm256_storeu_pd(m3_lanes + 4 * r, m3[r]);
+                _mm256_storeu_pd(m4_lanes + 4 * r, m4[r]);
+            }
+
+            return finish_central_moments(m2_lanes, m3_lanes, m4_lanes, values.subspan(n), mean);
+        }
+
+        // max_pd(t, -1) returns -1 for NaN, like histogram_bin. Bins are checked against bounds (gathered by bin)
+        // only in groups with t close to an integer 0..bin_count, and moved by one in floating point.
+        KERNELS_TARGET("avx2")
+        void histogram_avx2(std::span<const double> values, const HistogramEdges& edges, HistogramBins& local)
+        {
+            const __m256d low_v = _mm256_set1_pd(edges.low);
+            const __m256d scale_v = _mm256_set1_pd(edges.scale);
+            const __m256d min_v = _mm256_set1_pd(-1.0);
+            const __m256d max_v = _mm256_set1_pd(static_cast<double>(local.size() - 2));
+            const __m256d tolerance_v = _mm256_set1_pd(edges.tolerance);
+            const __m256d first_v = _mm256_set1_pd(-0.5);
+            const __m256d last_v = _mm256_set1_pd(static_cast<double>(local.size() - 2) + 0.5);
+            const __m256d sign_v = _mm256_set1_pd(-0.0);
+            const __m256d one_v = _mm256_set1_pd(1.0);
+            const __m256d zero = _mm256_setzero_pd(); // source of masked gathers, as in histogram_avx512
+            const __m256d all_lanes = _mm256_castsi256_pd(_mm256_set1_epi64x(-1));
+            const __m128i one = _mm_set1_epi32(1);
+            const double* bounds = edges.bounds.data();
+
+            const double* p = values.data();
+            const std::size_t n = vectorized_size(values);
+
+            alignas(32) std::int32_t bins[lane_count];
+            for (std::size_t i = 0; i < n; i += lane_count)
+            {
+                for (std::size_t r = 0; r < lane_count / 4; ++r)
+                {
+                    const __m256d v = _mm256_loadu_pd(p + i + 4 * r);
+                    const __m256d t = _mm256_mul_pd(_mm256_sub_pd(v, low_v), scale_v);
+                    __m256d floor_t = _mm256_floor_pd(_mm256_min_pd(_mm256_max_pd(t, min_v), max_v));
+                    __m128i bin = _mm_add_epi32(_mm256_cvttpd_epi32(floor_t), one);
+
+                    const __m256d distance = _mm256_andnot_pd(sign_v, _mm256_sub_pd(t, _mm256_round_pd(t, _MM_FROUND_TO_NEAREST_INT | _MM_FROUND_NO_EXC)));
+                    const __m256d near_edge = _mm256_and_pd(_mm256_cmp_pd(distance, tolerance_v, _CMP_LE_OQ),
+                        _mm256_and_pd(_mm256_cmp_pd(t, first_v, _CMP_GT_OQ), _mm256_cmp_pd(t, last_v, _CMP_LT_OQ)));
+                    if (_mm256_movemask_pd(near_edge) != 0)
+                    {
+                        const __m256d below = _mm256_cmp_pd(v, _mm256_mask_i32gather_pd(zero, bounds, bin, all_lanes, 8), _CMP_LT_OQ);
+                        const __m256d above = _mm256_cmp_pd(v, _mm256_mask_i32gather_pd(zero, bounds + 1, bin, all_lanes, 8), _CMP_GE_OQ);
+                        floor_t = _mm256_sub_pd(_mm256_add_pd(floor_t, _mm256_and_pd(above, one_v)), _mm256_and_pd(below, one_v));
+                        bin = _mm_add_epi32(_mm256_cvttpd_epi32(floor_t), one);
+                    }
+                    _mm_store_si128(reinterpret_cast<__m128i*>(bins + 4 * r), bin);
+                }
+                local.add_lanes(bins);
+            }
+
+            histogram_tail(values.subspan(n), edges, local);
+        }
+
+        KERNELS_TARGET("avx512f")
+        double sum_avx512(std::span<const double> values)
+        {
+            constexpr std::size_t regs = lane_count / 8;
+            __m512d acc[regs];
+            for (auto& a : acc)
+                a = _mm512_setzero_pd();
+
+            const double* p = values.data();
+            const std::size_t n = vectorized_size(values);
+            for (std::size_t i = 0; i < n; i += lane_count)
+                for (std::size_t r = 0; r < regs; ++r)
+                    acc[r] = _mm512_add_pd(acc[r], _mm512_loadu_pd(p + i + 8 * r));
+
+            double lanes[lane_count];
+            for (std::size_t r = 0; r < regs; ++r)
+                _mm512_storeu_pd(lanes + 8 * r, acc[r]);
+
+            return finish_sum(lanes, values.subspan(n));
+        }
+
+        KERNELS_TARGET("avx512f")
+        MinMaxResult min_max_avx512(std::span<const double> values)
+        {
+            constexpr std::size_t regs = lane_count / 8;
+            __m512d min_acc[regs];
+            __m512d max_acc[regs];
+            for (std::size_t r = 0; r < regs; ++r)
+                min_acc[r] = max_acc[r] = _mm512_set1_pd(values[0]);
+
+            // masked forms with all lanes set take an explicit source - unmasked ones read an undefined
+            // vector, which GCC 12 reports as maybe uninitialized
+            const __m512d zero = _mm512_setzero_pd();
+            const double* p = values.data();
+            const std::size_t n = vectorized_size(values);
+            for (std::size_t i = 0; i < n; i += lane_count)
+                for (std::size_t r = 0; r < regs; ++r)
+                {
+                    __m512d v = _mm512_loadu_pd(p + i + 8 * r);
+                    min_acc[r] = _mm512_mask_min_pd(zero, 0xFF, v, min_acc[r]);
+                    max_acc[r] = _mm512_mask_max_pd(zero, 0xFF, v, max_acc[r]);
+                }
+
+            double min_lanes[lane_count];
+            double max_lanes[lane_count];
+            for (std::size_t r = 0; r < regs; ++r)
+            {
+                _mm512_storeu_pd(min_lanes + 8 * r, min_acc[r]);
+                _mm512_storeu_pd(max_lanes + 8 * r, max_acc[r]);
+            }
+
+            return finish_min_max(min_lanes, max_lanes, values.subspan(n));
+        }
+
+        KERNELS_TARGET("avx512f")
+        CentralMoments central_moments_avx512(std::span<const double> values, double mean)
+        {
+            constexpr std::size_t regs = lane_count / 8;
+            __m512d m2[regs];
+            __m512d m3[regs];
+            __m512d m4[regs];
+            for (std::size_t r = 0; r < regs; ++r)
+                m2[r] = m3[r] = m4[r] = _mm512_setzero_pd();
+
+            const __m512d mean_v = _mm512_set1_pd(mean);
+            const double* p = values.data();
+            const std::size_t n = vectorized_size(values);
+            for (std::size_t i = 0; i < n; i += lane_count)
+                for (std::size_t r = 0; r < regs; ++r)
+                {
+                    __m512d d = _mm512_sub_pd(_mm512_loadu_pd(p + i + 8 * r), mean_v);
+                    __m512d d2 = _mm512_mul_pd(d, d);
+                    m2[r] = _mm512_add_pd(m2[r], d2);
+                    m3[r] = _mm512_add_pd(m3[r], _mm512_mul_pd(d2, d));
+                    m4[r] = _mm512_add_pd(m4[r], _mm512_mul_pd(d2, d2));
+                }
+
+            double m2_lanes[lane_count];
+            double m3_lanes[lane_count];
+            double m4_lanes[lane_count];
+            for (std::size_t r = 0; r < regs; ++r)
+            {
+                _mm512_storeu_pd(m2_lanes + 8 * r, m2[r]);
+                _mm512_storeu_pd(m3_lanes + 8 * r, m3[r]);
+                _mm512_storeu_pd(m4_lanes + 8 * r, m4[r]);
+            }
+
+            return finish_central_moments(m2_lanes, m3_lanes, m4_lanes, values.subspan(n), mean);
+        }
+
+        KERNELS_TARGET("avx512f")
+        void histogram_avx512(std::span<const double> values, const HistogramEdges& edges, HistogramBins& local)
+        {
+            const __m512d low_v = _mm512_set1_pd(edges.low);
+            const __m512d scale_v = _mm512_set1_pd(edges.scale);
+            const __m512d min_v = _mm512_set1_pd(-1.0);
+            const __m512d max_v = _mm512_set1_pd(static_cast<double>(local.size() - 2));
+            const __m512d tolerance_v = _mm512_set1_pd(edges.tolerance);
+            const __m512d first_v = _mm512_set1_pd(-0.5);
+            const __m512d last_v = _mm512_set1_pd(static_cast<double>(local.size() - 2) + 0.5);
+            const __m512d one_v = _mm512_set1_pd(1.0);
+            const double* bounds = edges.bounds.data();
+            const __m256i one = _mm256_set1_epi32(1);
+            const __m512d zero = _mm512_setzero_pd(); // source of masked forms, as in min_max_avx512
+            const __m256i zero_bins = _mm256_setzero_si256();
+
+            const double* p = values.data();
+            const std::size_t n = vectorized_size(values);
+
+            alignas(64) std::int32_t bins[lane_count];
+            for (std::size_t i = 0; i < n; i += lane_count)
+            {
+                for (std::size_t r = 0; r < lane_count / 8; ++r)
+                {
+                    const __m512d v = _mm512_loadu_pd(p + i + 8 * r);
+                    const __m512d t = _mm512_mul_pd(_mm512_sub_pd(v, low_v), scale_v);
+                    const __m512d clamped_t = _mm512_mask_min_pd(zero, 0xFF, _mm512_mask_max_pd(zero, 0xFF, t, min_v), max_v);
+                    __m256i bin = _mm256_add_epi32(_mm512_mask_cvt_roundpd_epi32(zero_bins, 0xFF, clamped_t, _MM_FROUND_TO_NEG_INF | _MM_FROUND_NO_EXC), one);
+
+                    const __m512d distance = _mm512_abs_pd(_mm512_sub_pd(t, _mm512_mask_roundscale_pd(zero, 0xFF, t, _MM_FROUND_TO_NEAREST_INT | _MM_FROUND_NO_EXC)));
+                    const __mmask8 near_edge = _mm512_cmp_pd_mask(distance, tolerance_v, _CMP_LE_OQ) & _mm512_cmp_pd_mask(t, first_v, _CMP_GT_OQ)
+                        & _mm512_cmp_pd_mask(t, last_v, _CMP_LT_OQ);
+                    if (near_edge != 0)
+                    {
+                        const __mmask8 below = _mm512_cmp_pd_mask(v, _mm512_mask_i32gather_pd(zero, 0xFF, bin, bounds, 8), _CMP_LT_OQ);
+                        const __mmask8 above = _mm512_cmp_pd_mask(v, _mm512_mask_i32gather_pd(zero, 0xFF, bin, bounds + 1, 8), _CMP_GE_OQ);
+                        bin = _mm256_add_epi32(bin, _mm512_mask_cvt_roundpd_epi32(zero_bins, 0xFF,
+                            _mm512_mask_sub_pd(_mm512_mask_mov_pd(zero, above, one_v), below, zero, one_v), _MM_FROUND_TO_ZERO | _MM_FROUND_NO_EXC));
+                    }
+                    _mm256_store_si256(reinterpret_cast<__m256i*>(bins + 8 * r), bin);
+                }
+                local.add_lanes(bins);
+            }
+
+            histogram_tail(values.subspan(n), edges, local);
+        }
+#endif
+    }
+
+    bool is_supported(Isa isa)
+    {
+        switch (isa)
+        {
+        case Isa::scalar:
+            return true;
+#if defined(KERNELS_X86) && (defined(__GNUC__) || defined(__clang__))
+        case Isa::sse2:
+            return __builtin_cpu_supports("sse2");
+        case Isa::avx2:
+            return __builtin_cpu_supports("avx2");
+        case Isa::avx512:
+            return __builtin_cpu_supports("avx512f");
+#elif defined(KERNELS_X86) && defined(_MSC_VER)
+        case Isa::sse2:
+        {
+            int info[4];
+            __cpuid(info, 1);
+            return (info[3] & (1 << 26)) != 0;
+        }
+        case Isa::avx2:
+        case Isa::avx512:
+        {
+            int info[4];
+            __cpuid(info, 1);
+            const bool os_saves_ymm = (info[2] & (1 << 27)) && (_xgetbv(0) & 0x6) == 0x6;
+            __cpuidex(info, 7, 0);
+            if (isa == Isa::avx2)
+                return os_saves_ymm && (info[1] & (1 << 5));
+            return os_saves_ymm && (_xgetbv(0) & 0xe6) == 0xe6 && (info[1] & (1 << 16));
+        }
+#endif
+        default:
+            return false;
+        }
+    }
+
+    Isa detect_isa()
+    {
+        for (Isa isa : {Isa::avx512, Isa::avx2, Isa::sse2})
+            if (is_supported(isa))
+                return isa;
+
+        return Isa::scalar;
+    }
+
+    const char* to_string(Isa isa)
+    {
+        switch (isa)
+        {
+        case Isa::sse2:
+            return "sse2";
+        case Isa::avx2:
+            return "avx2";
+        case Isa::avx512:
+            return "avx512";
+        default:
+            return "scalar";
+        }
+    }
+
+    double sum(std::span<const double> values, Isa isa)
+    {
+        switch (isa)
+        {
+#ifdef KERNELS_X86
+        case Isa::sse2:
+            return sum_sse2(values);
+        case Isa::avx2:
+            return sum_avx2(values);
+        case Isa::avx512:
+            return sum_avx512(values);
+#endif
+        default:
+            return sum_scalar(values);
+        }
+    }
+
+    MinMaxResult min_max(std::span<const double> values, Isa isa)
+    {
+        switch (isa)
+        {
+#ifdef KERNELS_X86
+        case Isa::sse2:
+            return min_max_sse2(values);
+        case Isa::avx2:
+            return min_max_avx2(values);
+        case Isa::avx512:
+            return min_max_avx512(values);
+#endif
+        default:
+            return min_max_scalar(values);
+        }
+    }
+
+    CentralMoments central_moments(std::span<const double> values, double mean, Isa isa)
+    {
+        switch (isa)
+        {
+#ifdef KERNELS_X86
+        case Isa::sse2:
+            return central_moments_sse2(values, mean);
+        case Isa::avx2:
+            return central_moments_avx2(values, mean);
+        case Isa::avx512:
+            return central_moments_avx512(values, mean);
+#endif
+        default:
+            return central_moments_scalar(values, mean);
+        }
+    }
+
+    void histogram(std::span<const double> values, const HistogramEdges& edges, HistogramBins& bins, Isa isa)
+    {
+        switch (isa)
+        {
+#ifdef KERNELS_X86
+        case Isa::avx2:
+            return histogram_avx2(values, edges, bins);
+        case Isa::avx512:
+            return histogram_avx512(values, edges, bins);
+#endif
+        default:
+            return histogram_scalar(values, edges, bins);
+        }
+    }
+}
@@ -0,0 +1,163 @@
+#ifndef KERNELS_HPP
+#define KERNELS_HPP
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <vector>
+
+// Reduction kernels used by Ver_2 statistics.
+//
+// Reduction order (identical for every ISA, so results are bit-compatible):
+//   * values are distributed over 16 lanes - value i goes to lane i % 16,
+//     each lane is reduced sequentially (sum: lane + value, min: value < lane ? value : lane,
+//     max: value > lane ? value : lane)
+//   * lanes are combined by halving: for w = 8, 4, 2, 1: lane[j] = op(lane[j + w], lane[j]) for j < w
+//   * sum of an empty range is 0.0, min/max lanes start with the first value
+namespace Kernels
+{
+    enum class Isa
+    {
+        scalar,
+        sse2,
+        avx2,
+        avx512
+    };
+
+    struct MinMaxResult
+    {
+        double min;
+        double max;
+    };
+
+    // sums of 2nd, 3rd and 4th powers of deviations from mean
+    struct CentralMoments
+    {
+        double m2;
+        double m3;
+        double m4;
+    };
+
+    // fixed-width bins of a histogram (see histogram)
+    struct HistogramEdges
+    {
+        double low;
+        double scale;
+        std::span<const double> bounds; // bin_count + 1 edges with a NaN on both sides
+        double tolerance;               // bins are checked against bounds only for (value - low) * scale this close to an integer
+    };
+
+    constexpr std::size_t lane_count = 16;
+
+    // Local bins of a histogram, kept by the caller (one per thread) from call to call - counts are spread over
+    // copy_count copies, so that runs of equal bins do not serialize on one counter. Copies are added up by counts().
+    class HistogramBins
+    {
+        std::size_t size_;
+        std::vector<std::uint64_t> copies_;
+
+    public:
+        static constexpr std::size_t copy_count = 4;
+
+        explicit HistogramBins(std::size_t size)
+            : size_{size}
+            , copies_(size * copy_count)
+        {
+        }
+
+        std::size_t size() const
+        {
+            return size_;
+        }
+
+        void clear()
+        {
+            std::fill(copies_.begin(), copies_.end(), 0);
+        }
+
+        void add(std::size_t bin, std::uint64_t count = 1)
+        {
+            copies_[bin] += count;
+        }
+
+        // bins of lane_count consecutive values, already shifted to [0, size)
+        void add_lanes(const std::int32_t* bins)
+        {
+            for (std::size_t j = 0; j < lane_count; ++j)
+                ++copies_[(j % copy_count) * size_ + bins[j]];
+        }
+
+        void merge(const HistogramBins& other)
+        {
+            for (std::size_t i = 0; i < copies_.size(); ++i)
+                copies_[i] += other.copies_[i];
+        }
+
+        std::vector<std::uint64_t> counts() const
+        {
+            std::vector<std::uint64_t> counts(copies_.begin(), copies_.begin() + size_);
+            for (std::size_t c = 1; c < copy_count; ++c)
+                for (std::size_t b = 0; b < size_; ++b)
+                    counts[b] += copies_[c * size_ + b];
+            return counts;
+        }
+    };
+
+    Isa detect_isa();
+    bool is_supported(Isa isa);
+    const char* to_string(Isa isa);
+
+    double sum(std::span<const double> values, Isa isa);
+
+    // requires non-empty values
+    MinMaxResult min_max(std::span<const double> values, Isa isa);
+
+    // uses the same lanes as sum, but results are not bit-compatible across ISAs (FMA contraction is allowed)
+    CentralMoments central_moments(std::span<const double> values, double mean, Isa isa);
+
+    // Fixed-width binning: bin of value is floor((value - low) * scale) clamped to [-1, bin_count] and shifted by one,
+    // so counts[0] counts values below low (and NaNs), counts[bin_count + 1] values at or above the upper edge.
+    // Rounding can put a value next to an edge into the neighbouring bin, so when (value - low) * scale is within tolerance
+    // of an integer the bin is moved by one if the value is outside [bounds[bin], bounds[bin + 1]) - counts are then those
+    // of comparing values with edges, as long as the tolerance covers every miss and is below one bin.
+    // Values are counted into bins, which must have bin_count + 2 bins - nothing is allocated or reduced per call.
+    // Counts are identical for every ISA (sse2 uses the scalar version).
+    void histogram(std::span<const double> values, const HistogramEdges& edges, HistogramBins& bins, Isa isa);
+
+    inline Isa active_isa()
+    {
+        static const Isa isa = detect_isa();
+        return isa;
+    }
+
+    // ISA used when none is requested - spans without a full step of lanes get the scalar kernel, which avoids
+    // switching to wide registers. Sums, minima, maxima and histogram counts are the same for every ISA;
+    // central moments can differ in the last bits (see central_moments).
+    inline Isa effective_isa(std::size_t size)
+    {
+        return size < lane_count ? Isa::scalar : active_isa();
+    }
+
+    inline double sum(std::span<const double> values)
+    {
+        return sum(values, effective_isa(values.size()));
+    }
+
+    inline MinMaxResult min_max(std::span<const double> values)
+    {
+        return min_max(values, effective_isa(values.size()));
+    }
+
+    inline CentralMoments central_moments(std::span<const double> values, double mean)
+    {
+        return central_moments(values, mean, effective_isa(values.size()));
+    }
+
+    inline void histogram(std::span<const double> values, const HistogramEdges& edges, HistogramBins& bins)
+    {
+        histogram(values, edges, bins, effective_isa(values.size()));
+    }
+}
+
+#endif // KERNELS_HPP
@@ -0,0 +1,136 @@
+#ifndef MAPPED_FILE_HPP
+#define MAPPED_FILE_HPP
+
+#include <cstddef>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <utility>
+
+#ifdef _WIN32
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+// Read-only view of a whole file mapped into memory
+class MappedFile
+{
+    const char* data_ = nullptr;
+    std::size_t size_ = 0;
+
+public:
+    explicit MappedFile(const std::string& file_name)
+    {
+#ifdef _WIN32
+        HANDLE file = CreateFileA(file_name.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+        if (file == INVALID_HANDLE_VALUE)
+            throw std::runtime_error("File not opened!!!");
+
+        LARGE_INTEGER file_size;
+        if (!GetFileSizeEx(file, &file_size))
+        {
+            CloseHandle(file);
+            throw std::runtime_error("File not opened!!!");
+        }
+        size_ = static_cast<std::size_t>(file_size.QuadPart);
+
+        if (size_ > 0)
+        {
+            HANDLE mapping = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+            if (mapping)
+            {
+                data_ = static_cast<const char*>(MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0));
+                CloseHandle(mapping);
+            }
+        }
+        CloseHandle(file);
+#else
+        int fd = ::open(file_name.c_str(), O_RDONLY);
+        if (fd == -1)
+            throw std::runtime_error("File not opened!!!");
+
+        struct stat file_stat;
+        if (::fstat(fd, &file_stat) == -1)
+        {
+            ::close(fd);
+            throw std::runtime_error("File not opened!!!");
+        }
+        size_ = static_cast<std::size_t>(file_stat.st_size);
+
+        if (size_ > 0)
+        {
+            void* addr = ::mmap(nullptr, size_, PROT_READ, MAP_PRIVATE, fd, 0);
+            if (addr != MAP_FAILED)
+            {
+                data_ = static_cast<const char*>(addr);
+                ::madvise(addr, size_, MADV_SEQUENTIAL);
+            }
+        }
+        ::close(fd);
+#endif
+        if (size_ > 0 && data_ == nullptr)
+            throw std::runtime_error("File not mapped!!!");
+    }
+
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    MappedFile(MappedFile&& other) noexcept
+        : data_{std::exchange(other.data_, nullptr)}
+        , size_{std::exchange(other.size_, 0)}
+    {
+    }
+
+    MappedFile& operator=(MappedFile&& other) noexcept
+    {
+        if (this != &other)
+        {
+            unmap();
+            data_ = std::exchange(other.data_, nullptr);
+            size_ = std::exchange(other.size_, 0);
+        }
+        return *this;
+    }
+
+    ~MappedFile()
+    {
+        unmap();
+    }
+
+    const char* data() const
+    {
+        return data_;
+    }
+
+    std::size_t size() const
+    {
+        return size_;
+    }
+
+    std::string_view view() const
+    {
+        return {data_, size_};
+    }
+
+private:
+    void unmap()
+    {
+        if (!data_)
+            return;
+#ifdef _WIN32
+        UnmapViewOfFile(data_);
+#else
+        ::munmap(const_cast<char*>(data_), size_);
+#endif
+        data_ = nullptr;
+    }
+};
+
+#endif // MAPPED_FILE_HPP
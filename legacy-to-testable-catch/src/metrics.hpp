@@ -0,0 +1,266 @@
+#ifndef METRICS_HPP
+#define METRICS_HPP
+
+#include <algorithm>
+#include <array>
+#include <charconv>
+#include <chrono>
+#include <cstdint>
+#include <fstream>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+// Instrumentation of analyzers. An analyzer with metrics enabled makes its AnalyzerMetrics the collector
+// of the current thread for the duration of each call; readers and parsers report into the collector - also
+// the buffers they allocate for loaded data. Without a collector every hook is a single thread-local check.
+// Work done on other threads is timed by the calling thread's phase. Readers that parse on worker threads give
+// every worker its own AnalyzerMetrics and add its counters to the caller's collector after the join (add_counters).
+namespace Metrics
+{
+    enum class Phase
+    {
+        load, // reading of data not attributed to parse
+        parse,
+        calculate,
+        save
+    };
+
+    inline constexpr std::array<std::string_view, 4> phase_names = {"load", "parse", "calculate", "save"};
+
+    struct PhaseStats
+    {
+        std::uint64_t calls = 0;
+        std::uint64_t nanoseconds = 0; // exclusive of nested phases
+
+        double seconds() const
+        {
+            return nanoseconds * 1e-9;
+        }
+    };
+
+    struct AnalyzerMetrics
+    {
+        std::array<PhaseStats, phase_names.size()> phases{};
+        std::uint64_t bytes_read = 0;
+        std::uint64_t values_parsed = 0; // values parsed from text or decoded from binary files
+        std::uint64_t allocations = 0; // buffers allocated for loaded data
+        std::uint64_t allocated_bytes = 0;
+
+        const PhaseStats& phase(Phase phase) const
+        {
+            return phases[static_cast<std::size_t>(phase)];
+        }
+
+        PhaseStats& phase(Phase phase)
+        {
+            return phases[static_cast<std::size_t>(phase)];
+        }
+    };
+
+    class ScopedPhase;
+
+    inline thread_local AnalyzerMetrics* collector = nullptr;
+    inline thread_local ScopedPhase* current_phase = nullptr;
+
+    // Makes metrics the collector of the current thread until the end of scope (nullptr disables collection)
+    class Scope
+    {
+        AnalyzerMetrics* previous_;
+
+    public:
+        explicit Scope(AnalyzerMetrics* metrics)
+            : previous_{collector}
+        {
+            collector = metrics;
+        }
+
+        Scope(const Scope&) = delete;
+        Scope& operator=(const Scope&) = delete;
+
+        ~Scope()
+        {
+            collector = previous_;
+        }
+    };
+
+    // Times a phase - time of nested phases is attributed only to them
+    class ScopedPhase
+    {
+        PhaseStats* stats_ = nullptr;
+        ScopedPhase* parent_ = nullptr;
+        std::chrono::steady_clock::time_point start_;
+        std::uint64_t nested_nanoseconds_ = 0;
+
+    public:
+        explicit ScopedPhase(Phase phase)
+        {
+            if (AnalyzerMetrics* metrics = collector)
+            {
+                stats_ = &metrics->phase(phase);
+                parent_ = std::exchange(current_phase, this);
+                start_ = std::chrono::steady_clock::now();
+            }
+        }
+
+        ScopedPhase(const ScopedPhase&) = delete;
+        ScopedPhase& operator=(const ScopedPhase&) = delete;
+
+        ~ScopedPhase()
+        {
+            if (!stats_)
+                return;
+
+            const auto elapsed = static_cast<std::uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start_).count());
+            ++stats_->calls;
+            stats_->nanoseconds += elapsed - std::min(elapsed, nested_nanoseconds_);
+            if (parent_)
+                parent_->nested_nanoseconds_ += elapsed;
+            current_phase = parent_;
+        }
+    };
+
+    inline void add_bytes_read(std::uint64_t bytes)
+    {
+        if (AnalyzerMetrics* metrics = collector)
+            metrics->bytes_read += bytes;
+    }
+
+    inline void add_values_parsed(std::uint64_t count)
+    {
+        if (AnalyzerMetrics* metrics = collector)
+            metrics->values_parsed += count;
+    }
+
+    inline void add_allocation(std::uint64_t bytes)
+    {
+        if (AnalyzerMetrics* metrics = collector)
+        {
+            ++metrics->allocations;
+            metrics->allocated_bytes += bytes;
+        }
+    }
+
+    // counters collected on another thread (its phase times are not added - the calling thread times the work)
+    inline void add_counters(const AnalyzerMetrics& other)
+    {
+        if (AnalyzerMetrics* metrics = collector)
+        {
+            metrics->bytes_read += other.bytes_read;
+            metrics->values_parsed += other.values_parsed;
+            metrics->allocations += other.allocations;
+            metrics->allocated_bytes += other.allocated_bytes;
+        }
+    }
+
+    // Counts buffers allocated by a vector that grows while values are appended - call update() after every append.
+    // Reports into the collector of the thread that created it; without one update() returns at once.
+    template <typename T>
+    class GrowthCounter
+    {
+        const std::vector<T>& values_;
+        std::size_t capacity_;
+        AnalyzerMetrics* metrics_;
+
+    public:
+        explicit GrowthCounter(const std::vector<T>& values)
+            : values_{values}
+            , capacity_{values.capacity()}
+            , metrics_{collector}
+        {
+        }
+
+        void update()
+        {
+            if (!metrics_ || values_.capacity() == capacity_)
+                return;
+
+            capacity_ = values_.capacity();
+            ++metrics_->allocations;
+            metrics_->allocated_bytes += capacity_ * sizeof(T);
+        }
+    };
+
+    namespace Details
+    {
+        template <typename T>
+        void append_number(std::string& out, T value)
+        {
+            char digits[32];
+            auto [end, ec] = std::to_chars(digits, digits + sizeof(digits), value);
+            out.append(digits, end);
+        }
+    }
+
+    // Prometheus text exposition format - counters named <prefix>_phase_seconds_total{phase="..."} etc.
+    inline std::string to_prometheus(const AnalyzerMetrics& metrics, std::string_view prefix = "data_analyzer")
+    {
+        std::string out;
+
+        auto counter = [&](std::string_view name, std::string_view help, auto value_of, bool per_phase) {
+            out.append("# HELP ").append(prefix).append("_").append(name).append(" ").append(help).append("\n");
+            out.append("# TYPE ").append(prefix).append("_").append(name).append(" counter\n");
+            for (std::size_t i = 0; i < (per_phase ? phase_names.size() : 1); ++i)
+            {
+                out.append(prefix).append("_").append(name);
+                if (per_phase)
+                    out.append("{phase=\"").append(phase_names[i]).append("\"}");
+                out.append(" ");
+                Details::append_number(out, value_of(i));
+                out.append("\n");
+            }
+        };
+
+        counter("phase_seconds_total", "Time spent in phase.", [&](std::size_t i) { return metrics.phases[i].seconds(); }, true);
+        counter("phase_calls_total", "Number of times phase was entered.", [&](std::size_t i) { return metrics.phases[i].calls; }, true);
+        counter("bytes_read_total", "Bytes of data files read.", [&](std::size_t) { return metrics.bytes_read; }, false);
+        counter("values_parsed_total", "Values parsed or decoded.", [&](std::size_t) { return metrics.values_parsed; }, false);
+        counter("allocations_total", "Buffers allocated for loaded data.", [&](std::size_t) { return metrics.allocations; }, false);
+        counter("allocated_bytes_total", "Bytes of buffers allocated for loaded data.", [&](std::size_t) { return metrics.allocated_bytes; }, false);
+
+        return out;
+    }
+
+    // {"phases":{"load":{"calls":1,"seconds":0.5},...},"bytes_read":...,"values_parsed":...,"allocations":...,"allocated_bytes":...}
+    inline std::string to_json(const AnalyzerMetrics& metrics)
+    {
+        std::string out = "{\"phases\":{";
+        for (std::size_t i = 0; i < phase_names.size(); ++i)
+        {
+            out.append(i > 0 ? ",\"" : "\"").append(phase_names[i]).append("\":{\"calls\":");
+            Details::append_number(out, metrics.phases[i].calls);
+            out.append(",\"seconds\":");
+            Details::append_number(out, metrics.phases[i].seconds());
+            out.append("}");
+        }
+        out.append("},\"bytes_read\":");
+        Details::append_number(out, metrics.bytes_read);
+        out.append(",\"values_parsed\":");
+        Details::append_number(out, metrics.values_parsed);
+        out.append(",\"allocations\":");
+        Details::append_number(out, metrics.allocations);
+        out.append(",\"allocated_bytes\":");
+        Details::append_number(out, metrics.allocated_bytes);
+        out.append("}");
+        return out;
+    }
+
+    enum class Format
+    {
+        prometheus,
+        json
+    };
+
+    inline void save(const AnalyzerMetrics& metrics, const std::string& file_name, Format format = Format::prometheus)
+    {
+        std::ofstream out{file_name, std::ios::binary};
+        if (!out)
+            throw std::runtime_error("File not opened!!!");
+
+        out << (format == Format::prometheus ? to_prometheus(metrics) : to_json(metrics) + "\n");
+    }
+}
+
+#endif // METRICS_HPP
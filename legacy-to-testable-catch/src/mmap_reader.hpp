@@ -0,0 +1,80 @@
+#ifndef MMAP_READER_HPP
+#define MMAP_READER_HPP
+
+#include "data_analyzer.hpp"
+#include "mapped_file.hpp"
+
+#include <algorithm>
+#include <charconv>
+#include <limits>
+#include <string>
+#include <string_view>
+
+inline bool is_number_separator(char c)
+{
+    return c == ' ' || c == '\n' || c == '\t' || c == '\r' || c == '\v' || c == '\f';
+}
+
+// Parses whitespace separated numbers from text and appends at most max_count of them to data.
+// Like `ifstream >> T` it stops at the first token that is not a number (for integers also at a fraction or exponent).
+// Returns the number of characters consumed.
+template <DataElement T>
+std::size_t parse_numbers(std::string_view text, BasicData<T>& data, std::size_t max_count = std::numeric_limits<std::size_t>::max())
+{
+    Metrics::ScopedPhase phase{Metrics::Phase::parse};
+
+    const char* first = text.data();
+    const char* const last = text.data() + text.size();
+    const std::size_t initial_size = data.size();
+    Metrics::GrowthCounter growth{data};
+
+    for (std::size_t parsed = 0; parsed < max_count; ++parsed)
+    {
+        while (first != last && is_number_separator(*first))
+            ++first;
+
+        if (first == last)
+            break;
+
+        const char* token = first;
+        if (*token == '+') // from_chars does not accept an explicit plus sign
+            ++token;
+
+        T d;
+        auto [ptr, ec] = std::from_chars(token, last, d);
+        if (ec != std::errc{})
+            break;
+
+        data.push_back(d);
+        growth.update();
+        first = ptr;
+    }
+
+    Metrics::add_values_parsed(data.size() - initial_size);
+
+    return static_cast<std::size_t>(first - text.data());
+}
+
+// Reads numbers straight out of a memory mapped file - locale independent replacement for basic_text_reader
+template <DataElement T>
+BasicData<T> basic_mmap_reader(const std::string& file_name)
+{
+    MappedFile file{file_name};
+    std::string_view text = file.view();
+    Metrics::add_bytes_read(text.size());
+
+    BasicData<T> data;
+    data.reserve(std::count(text.begin(), text.end(), '\n') + 1);
+    Metrics::add_allocation(data.capacity() * sizeof(T));
+
+    parse_numbers(text, data);
+
+    return data;
+}
+
+inline Data mmap_reader(const std::string& file_name)
+{
+    return basic_mmap_reader<double>(file_name);
+}
+
+#endif // MMAP_READER_HPP
@@ -0,0 +1,130 @@
+#ifndef PARALLEL_READER_HPP
+#define PARALLEL_READER_HPP
+
+#include "mmap_reader.hpp"
+
+#include <algorithm>
+#include <future>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+// Splits text into at most chunk_count consecutive ranges that end on a number separator,
+// so that no number is cut in half. Returns chunk boundaries: [0, ..., text.size()]
+inline std::vector<std::size_t> split_on_separators(std::string_view text, std::size_t chunk_count)
+{
+    std::vector<std::size_t> bounds{0};
+
+    for (std::size_t i = 1; i < chunk_count; ++i)
+    {
+        std::size_t pos = std::max(text.size() / chunk_count * i, bounds.back());
+        while (pos < text.size() && !is_number_separator(text[pos]))
+            ++pos;
+
+        if (pos > bounds.back() && pos < text.size())
+            bounds.push_back(pos);
+    }
+
+    bounds.push_back(text.size());
+
+    return bounds;
+}
+
+class ParallelReader
+{
+    std::size_t thread_count_;
+    std::size_t min_chunk_size_;
+
+public:
+    static constexpr std::size_t default_min_chunk_size = 1024 * 1024;
+
+    explicit ParallelReader(std::size_t thread_count = std::thread::hardware_concurrency(), std::size_t min_chunk_size = default_min_chunk_size)
+        : thread_count_{std::max<std::size_t>(thread_count, 1)}
+        , min_chunk_size_{std::max<std::size_t>(min_chunk_size, 1)}
+    {
+    }
+
+    Data operator()(const std::string& file_name) const
+    {
+        MappedFile file{file_name};
+        std::string_view text = file.view();
+        Metrics::add_bytes_read(text.size());
+
+        std::size_t chunk_count = std::min(thread_count_, text.size() / min_chunk_size_ + 1);
+        std::vector<std::size_t> bounds = split_on_separators(text, chunk_count);
+        chunk_count = bounds.size() - 1;
+
+        struct Chunk
+        {
+            Data data;
+            bool complete;
+            Metrics::AnalyzerMetrics metrics; // of the worker that parsed the chunk
+        };
+
+        const bool collect_metrics = Metrics::collector != nullptr;
+
+        std::vector<Chunk> chunks;
+        chunks.reserve(chunk_count);
+        {
+            Metrics::ScopedPhase phase{Metrics::Phase::parse};
+
+            std::vector<std::future<Chunk>> parsed;
+            parsed.reserve(chunk_count);
+            for (std::size_t i = 0; i < chunk_count; ++i)
+            {
+                std::string_view range = text.substr(bounds[i], bounds[i + 1] - bounds[i]);
+
+                parsed.push_back(std::async(std::launch::async, [range, collect_metrics] {
+                    Chunk chunk;
+                    {
+                        Metrics::Scope metrics_scope{collect_metrics ? &chunk.metrics : nullptr};
+                        chunk.data.reserve(std::count(range.begin(), range.end(), '\n') + 1);
+                        Metrics::add_allocation(chunk.data.capacity() * sizeof(double));
+                        chunk.complete = parse_numbers(range, chunk.data) == range.size();
+                    }
+                    return chunk;
+                }));
+            }
+
+            for (auto& f : parsed)
+                chunks.push_back(f.get());
+        }
+
+        for (const auto& chunk : chunks)
+            Metrics::add_counters(chunk.metrics);
+
+        // like text_reader - everything after the first invalid token is ignored
+        auto last_chunk = std::find_if(chunks.begin(), chunks.end(), [](const Chunk& c) { return !c.complete; });
+        if (last_chunk != chunks.end())
+            ++last_chunk;
+
+        if (std::distance(chunks.begin(), last_chunk) == 1)
+            return std::move(chunks.front().data);
+
+        std::vector<std::size_t> offsets{0};
+        for (auto it = chunks.begin(); it != last_chunk; ++it)
+            offsets.push_back(offsets.back() + it->data.size());
+
+        Data data(offsets.back());
+        Metrics::add_allocation(data.size() * sizeof(double));
+
+        std::vector<std::future<void>> copied;
+        for (auto it = chunks.begin(); it != last_chunk; ++it)
+        {
+            auto dest = data.begin() + offsets[std::distance(chunks.begin(), it)];
+            copied.push_back(std::async(std::launch::async, [it, dest] { std::copy(it->data.begin(), it->data.end(), dest); }));
+        }
+        for (auto& f : copied)
+            f.get();
+
+        return data;
+    }
+};
+
+inline Data parallel_reader(const std::string& file_name)
+{
+    return ParallelReader{}(file_name);
+}
+
+#endif // PARALLEL_READER_HPP
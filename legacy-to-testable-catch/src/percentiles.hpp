@@ -0,0 +1,224 @@
+#ifndef PERCENTILES_HPP
+#define PERCENTILES_HPP
+
+#include "data_analyzer.hpp"
+#include "quantiles.hpp"
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cmath>
+#include <cstdint>
+#include <future>
+#include <iterator>
+#include <limits>
+#include <span>
+#include <thread>
+#include <vector>
+
+namespace RadixSort
+{
+    constexpr unsigned digit_bits = 11;
+    constexpr std::size_t bucket_count = std::size_t{1} << digit_bits;
+    constexpr unsigned pass_count = (64 + digit_bits - 1) / digit_bits;
+    constexpr std::size_t min_parallel_size = 64 * 1024;
+
+    // maps IEEE-754 bit pattern to unsigned key with the same order as doubles (-0.0 is placed before +0.0)
+    inline std::uint64_t to_key(double value)
+    {
+        auto bits = std::bit_cast<std::uint64_t>(value);
+        return (bits & 0x8000'0000'0000'0000ull) ? ~bits : bits | 0x8000'0000'0000'0000ull;
+    }
+
+    inline double from_key(std::uint64_t key)
+    {
+        return std::bit_cast<double>((key & 0x8000'0000'0000'0000ull) ? key & ~0x8000'0000'0000'0000ull : ~key);
+    }
+
+    // Parallel LSD radix sort: in every pass each thread builds a histogram of its range,
+    // global offsets are calculated per thread and each thread scatters its range (stable)
+    inline void sort(std::span<double> values, std::size_t thread_count = std::thread::hardware_concurrency())
+    {
+        const std::size_t n = values.size();
+        thread_count = std::clamp<std::size_t>(thread_count, 1, n / min_parallel_size + 1);
+        const std::size_t chunk_size = (n + thread_count - 1) / thread_count;
+
+        std::vector<std::uint64_t> keys(n);
+        std::vector<std::uint64_t> buffer(n);
+
+        auto for_each_chunk = [&](auto task) {
+            std::vector<std::future<void>> tasks;
+            for (std::size_t t = 0; t < thread_count; ++t)
+            {
+                const std::size_t first = std::min(n, t * chunk_size);
+                const std::size_t last = std::min(n, first + chunk_size);
+                tasks.push_back(std::async(std::launch::async, task, t, first, last));
+            }
+            for (auto& f : tasks)
+                f.get();
+        };
+
+        for_each_chunk([&](std::size_t, std::size_t first, std::size_t last) {
+            for (std::size_t i = first; i < last; ++i)
+                keys[i] = to_key(values[i]);
+        });
+
+        std::vector<std::array<std::size_t, bucket_count>> offsets(thread_count);
+
+        for (unsigned pass = 0; pass < pass_count; ++pass)
+        {
+            const unsigned shift = pass * digit_bits;
+
+            for_each_chunk([&](std::size_t t, std::size_t first, std::size_t last) {
+                auto& histogram = offsets[t];
+                histogram.fill(0);
+                for (std::size_t i = first; i < last; ++i)
+                    ++histogram[(keys[i] >> shift) & (bucket_count - 1)];
+            });
+
+            // all keys have the same digit - pass would not change the order
+            bool single_bucket = false;
+            for (std::size_t b = 0; b < bucket_count && !single_bucket; ++b)
+            {
+                std::size_t total = 0;
+                for (const auto& histogram : offsets)
+                    total += histogram[b];
+                single_bucket = total == n;
+            }
+            if (single_bucket)
+                continue;
+
+            std::size_t offset = 0;
+            for (std::size_t b = 0; b < bucket_count; ++b)
+                for (auto& histogram : offsets)
+                    offset += std::exchange(histogram[b], offset);
+
+            for_each_chunk([&](std::size_t t, std::size_t first, std::size_t last) {
+                auto& bucket_offsets = offsets[t];
+                for (std::size_t i = first; i < last; ++i)
+                    buffer[bucket_offsets[(keys[i] >> shift) & (bucket_count - 1)]++] = keys[i];
+            });
+
+            keys.swap(buffer);
+        }
+
+        for_each_chunk([&](std::size_t, std::size_t first, std::size_t last) {
+            for (std::size_t i = first; i < last; ++i)
+                values[i] = from_key(keys[i]);
+        });
+    }
+}
+
+namespace Ver_2
+{
+    // Exact percentiles (nearest-rank definition: the smallest value with at least q * n values less or equal).
+    // For a few ranks values are selected with nth_element, otherwise all data is sorted with parallel radix sort.
+    // NaNs are ignored.
+    class Percentiles : public IStatistics
+    {
+    public:
+        enum class Strategy
+        {
+            automatic,
+            selection,
+            radix_sort
+        };
+
+        static constexpr std::size_t max_ranks_for_selection = 16;
+
+        explicit Percentiles(std::vector<double> percentiles = {0.5, 0.9, 0.99, 0.999}, Strategy strategy = Strategy::automatic,
+            std::size_t thread_count = std::thread::hardware_concurrency())
+            : percentiles_{std::move(percentiles)}
+            , strategy_{strategy}
+            , thread_count_{thread_count}
+        {
+        }
+
+        Strategy strategy() const
+        {
+            if (strategy_ != Strategy::automatic)
+                return strategy_;
+
+            return percentiles_.size() <= max_ranks_for_selection ? Strategy::selection : Strategy::radix_sort;
+        }
+
+        Results calculate(const Data& data) override
+        {
+            Data values;
+            values.reserve(data.size());
+            std::copy_if(data.begin(), data.end(), std::back_inserter(values), [](double value) { return !std::isnan(value); });
+
+            Results results;
+            if (values.empty())
+            {
+                for (double q : percentiles_)
+                    results.push_back(StatResult(Quantiles::description(q), std::numeric_limits<double>::quiet_NaN()));
+                return results;
+            }
+
+            std::vector<std::size_t> ranks;
+            for (double q : percentiles_)
+                ranks.push_back(rank(q, values.size()));
+
+            if (strategy() == Strategy::selection)
+            {
+                std::vector<std::size_t> sorted_ranks = ranks;
+                std::sort(sorted_ranks.begin(), sorted_ranks.end());
+                sorted_ranks.erase(std::unique(sorted_ranks.begin(), sorted_ranks.end()), sorted_ranks.end());
+                select(values, 0, values.size(), sorted_ranks);
+            }
+            else
+            {
+                RadixSort::sort(values, thread_count_);
+            }
+
+            for (std::size_t i = 0; i < percentiles_.size(); ++i)
+                results.push_back(StatResult(Quantiles::description(percentiles_[i]), values[ranks[i]]));
+
+            return results;
+        }
+
+        // strategy and thread count do not change results
+        std::string kind() const override
+        {
+            StateWriter kind{"Percentiles"};
+            kind.write_array(percentiles_.data(), percentiles_.size());
+            return kind.str();
+        }
+
+        static std::size_t rank(double q, std::size_t count)
+        {
+            // q is rarely exact in binary (0.07 * 100 is 7.000000000000001), so products within a few ulps of
+            // an integer are taken as that integer instead of rounding up to the next rank
+            const double product = std::clamp(q, 0.0, 1.0) * static_cast<double>(count);
+            const auto position = static_cast<std::size_t>(std::ceil(product - product * 4 * std::numeric_limits<double>::epsilon()));
+            return position == 0 ? 0 : position - 1;
+        }
+
+    private:
+        std::vector<double> percentiles_;
+        Strategy strategy_;
+        std::size_t thread_count_;
+
+        // places values at sorted ranks (a subrange of ranks within [first, last)) - O(n log k) for k ranks
+        static void select(Data& values, std::size_t first, std::size_t last, std::span<const std::size_t> ranks)
+        {
+            if (ranks.empty())
+                return;
+
+            const std::size_t middle = ranks.size() / 2;
+            const std::size_t nth = ranks[middle];
+            std::nth_element(values.begin() + first, values.begin() + nth, values.begin() + last);
+
+            select(values, first, nth, ranks.first(middle));
+            select(values, nth + 1, last, ranks.subspan(middle + 1));
+        }
+    };
+
+    namespace Statistics
+    {
+        inline auto percentiles = std::make_shared<Percentiles>();
+    }
+}
+
+#endif // PERCENTILES_HPP
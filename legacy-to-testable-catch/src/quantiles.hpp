@@ -0,0 +1,348 @@
+#ifndef QUANTILES_HPP
+#define QUANTILES_HPP
+
+#include "data_analyzer.hpp"
+
+#include <charconv>
+#include <cmath>
+#include <cstdint>
+#include <limits>
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include <vector>
+
+// KLL quantile sketch (Karnin, Lang, Liberty) - memory depends only on k (about 3k values),
+// rank error is roughly 1.7 / k. Sketches can be merged.
+class KllSketch
+{
+    static constexpr double capacity_ratio = 2.0 / 3.0;
+
+    std::uint32_t k_;
+    std::uint64_t count_ = 0;
+    double min_ = std::numeric_limits<double>::quiet_NaN();
+    double max_ = std::numeric_limits<double>::quiet_NaN();
+    std::uint64_t random_state_ = 0x9e3779b97f4a7c15ull; // coin flips for compaction - fixed seed gives reproducible results
+    std::vector<std::vector<double>> levels_;
+    std::vector<std::size_t> capacities_;
+    std::size_t size_ = 0;
+    std::size_t max_size_ = 0;
+
+public:
+    static constexpr std::uint32_t default_k = 200;
+
+    explicit KllSketch(std::uint32_t k = default_k)
+        : k_{std::max<std::uint32_t>(k, 8)}
+    {
+        add_level();
+    }
+
+    std::uint32_t k() const
+    {
+        return k_;
+    }
+
+    std::uint64_t count() const
+    {
+        return count_;
+    }
+
+    // number of values retained by sketch
+    std::size_t size() const
+    {
+        return size_;
+    }
+
+    // number of values the level buffers can hold - memory of the sketch is about capacity() * sizeof(double)
+    std::size_t capacity() const
+    {
+        std::size_t capacity = 0;
+        for (const auto& level : levels_)
+            capacity += level.capacity();
+        return capacity;
+    }
+
+    void update(double value)
+    {
+        if (std::isnan(value))
+            return;
+
+        if (count_ == 0 || value < min_)
+            min_ = value;
+        if (count_ == 0 || value > max_)
+            max_ = value;
+        ++count_;
+
+        levels_[0].push_back(value);
+        if (++size_ >= max_size_)
+            compress();
+    }
+
+    // sketches must have the same k - rank error of a merged sketch is that of the larger k only if all parts share it
+    void merge(const KllSketch& other)
+    {
+        if (other.k_ != k_)
+            throw std::invalid_argument("Sketches of different k!!!");
+        if (other.count_ == 0)
+            return;
+
+        if (count_ == 0 || other.min_ < min_)
+            min_ = other.min_;
+        if (count_ == 0 || other.max_ > max_)
+            max_ = other.max_;
+        count_ += other.count_;
+
+        while (levels_.size() < other.levels_.size())
+            add_level();
+        for (std::size_t h = 0; h < other.levels_.size(); ++h)
+        {
+            levels_[h].insert(levels_[h].end(), other.levels_[h].begin(), other.levels_[h].end());
+            size_ += other.levels_[h].size();
+        }
+
+        compress();
+    }
+
+    // q in [0, 1]
+    double quantile(double q) const
+    {
+        if (count_ == 0)
+            return std::numeric_limits<double>::quiet_NaN();
+        if (q <= 0.0)
+            return min_;
+        if (q >= 1.0)
+            return max_;
+
+        std::vector<std::pair<double, std::uint64_t>> weighted;
+        weighted.reserve(size_);
+        for (std::size_t h = 0; h < levels_.size(); ++h)
+            for (double value : levels_[h])
+                weighted.emplace_back(value, std::uint64_t{1} << h);
+        std::sort(weighted.begin(), weighted.end());
+
+        std::uint64_t total_weight = 0;
+        for (const auto& item : weighted)
+            total_weight += item.second;
+
+        const double rank = q * total_weight;
+        std::uint64_t cumulative_weight = 0;
+        for (const auto& [value, weight] : weighted)
+        {
+            cumulative_weight += weight;
+            if (cumulative_weight >= rank)
+                return value;
+        }
+
+        return max_;
+    }
+
+    void serialize(StateWriter& state) const
+    {
+        state.write(k_);
+        state.write(count_);
+        state.write(min_);
+        state.write(max_);
+        state.write(random_state_);
+        state.write(static_cast<std::uint64_t>(levels_.size()));
+        for (const auto& level : levels_)
+            state.write_array(level.data(), level.size());
+    }
+
+    // state must be of a sketch with the same k
+    void deserialize(StateReader& state)
+    {
+        const auto k = state.read<std::uint32_t>();
+        const auto count = state.read<std::uint64_t>();
+        const auto min = state.read<double>();
+        const auto max = state.read<double>();
+        const auto random_state = state.read<std::uint64_t>();
+
+        const auto level_count = state.read<std::uint64_t>();
+        if (k != k_ || level_count == 0 || level_count > 64)
+            throw std::runtime_error("Invalid accumulator state!!!");
+
+        std::vector<std::vector<double>> levels(level_count);
+        std::uint64_t weight = 0; // values of level h stand for 2^h values each, so weights add up to count
+        for (std::size_t h = 0; h < levels.size(); ++h)
+        {
+            levels[h] = state.read_array<double>();
+            if (levels[h].size() > ((count - weight) >> h))
+                throw std::runtime_error("Invalid accumulator state!!!");
+            weight += static_cast<std::uint64_t>(levels[h].size()) << h;
+        }
+        if (weight != count)
+            throw std::runtime_error("Invalid accumulator state!!!");
+
+        count_ = count;
+        min_ = min;
+        max_ = max;
+        random_state_ = random_state;
+        levels_.clear();
+        size_ = 0;
+        while (levels_.size() < level_count)
+            add_level();
+        for (std::size_t h = 0; h < levels.size(); ++h)
+        {
+            levels_[h] = std::move(levels[h]);
+            size_ += levels_[h].size();
+        }
+    }
+
+private:
+    // capacity of level h is k * (2/3)^(depth of h below the top level), at least 2
+    void add_level()
+    {
+        levels_.emplace_back();
+        capacities_.resize(levels_.size());
+
+        max_size_ = 0;
+        for (std::size_t h = 0; h < levels_.size(); ++h)
+        {
+            const auto depth = static_cast<double>(levels_.size() - h - 1);
+            capacities_[h] = std::max<std::size_t>(2, static_cast<std::size_t>(std::ceil(k_ * std::pow(capacity_ratio, depth))));
+            max_size_ += capacities_[h];
+        }
+    }
+
+    bool random_bit()
+    {
+        random_state_ ^= random_state_ << 13;
+        random_state_ ^= random_state_ >> 7;
+        random_state_ ^= random_state_ << 17;
+        return random_state_ & 1;
+    }
+
+    // halves the lowest overfull levels by promoting every other sorted value to the next level
+    void compress()
+    {
+        while (size_ >= max_size_)
+        {
+            for (std::size_t h = 0; h < levels_.size(); ++h)
+            {
+                if (levels_[h].size() < capacities_[h])
+                    continue;
+
+                if (h + 1 == levels_.size())
+                    add_level();
+
+                auto& level = levels_[h];
+                std::sort(level.begin(), level.end());
+
+                // with odd count the last value stays at this level
+                std::size_t compacted = level.size() - level.size() % 2;
+                for (std::size_t i = random_bit() ? 1 : 0; i < compacted; i += 2)
+                    levels_[h + 1].push_back(level[i]);
+
+                level.erase(level.begin(), level.begin() + compacted);
+                size_ -= compacted / 2;
+
+                // erase keeps the buffer - a level that outgrew its capacity gives the memory back,
+                // so buffers of all levels stay within a small multiple of the retained values
+                if (level.capacity() > 2 * capacities_[h])
+                    level.shrink_to_fit();
+                break;
+            }
+        }
+    }
+};
+
+namespace Ver_2
+{
+    // Approximate quantiles in bounded memory (see KllSketch)
+    class Quantiles : public IStreamingStatistics
+    {
+        std::uint32_t k_;
+        std::vector<double> quantiles_;
+
+    public:
+        class Accumulator : public IAccumulator
+        {
+            std::vector<double> quantiles_;
+            KllSketch sketch_;
+
+        public:
+            Accumulator(std::vector<double> quantiles, std::uint32_t k)
+                : quantiles_{std::move(quantiles)}
+                , sketch_{k}
+            {
+            }
+
+            void init() override
+            {
+                sketch_ = KllSketch{sketch_.k()};
+            }
+
+            void update(std::span<const double> values) override
+            {
+                for (double value : values)
+                    sketch_.update(value);
+            }
+
+            Results finalize() const override
+            {
+                Results results;
+                for (double q : quantiles_)
+                    results.push_back(StatResult(description(q), sketch_.quantile(q)));
+                return results;
+            }
+
+            void merge(const IAccumulator& other) override
+            {
+                sketch_.merge(same_kind<Accumulator>(other).sketch_);
+            }
+
+            std::string serialize() const override
+            {
+                StateWriter state{"Quantiles"};
+                sketch_.serialize(state);
+                return state.str();
+            }
+
+            void deserialize(std::string_view bytes) override
+            {
+                StateReader state{bytes, "Quantiles"};
+                sketch_.deserialize(state);
+                state.expect_end();
+            }
+
+            const KllSketch& sketch() const
+            {
+                return sketch_;
+            }
+        };
+
+        explicit Quantiles(std::vector<double> quantiles = {0.5, 0.9, 0.99, 0.999}, std::uint32_t k = KllSketch::default_k)
+            : k_{k}
+            , quantiles_{std::move(quantiles)}
+        {
+        }
+
+        std::unique_ptr<IAccumulator> make_accumulator() const override
+        {
+            return std::make_unique<Accumulator>(quantiles_, k_);
+        }
+
+        std::string kind() const override
+        {
+            StateWriter kind{"Quantiles"};
+            kind.write(k_);
+            kind.write_array(quantiles_.data(), quantiles_.size());
+            return kind.str();
+        }
+
+        // 0.5 -> "P50", 0.999 -> "P99.9"
+        static std::string description(double q)
+        {
+            char buffer[32];
+            auto [ptr, ec] = std::to_chars(std::begin(buffer), std::end(buffer), std::round(q * 1e6) / 1e4);
+            return "P" + std::string(buffer, ptr);
+        }
+    };
+
+    namespace Statistics
+    {
+        inline auto quantiles = std::make_shared<Quantiles>();
+    }
+}
+
+#endif // QUANTILES_HPP
@@ -0,0 +1,376 @@
+#ifndef RESULT_CACHE_HPP
+#define RESULT_CACHE_HPP
+
+#include "binary_format.hpp"
+#include "data_analyzer.hpp"
+#include "mapped_file.hpp"
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#ifdef _WIN32
+#include <process.h>
+#else
+#include <unistd.h>
+#endif
+
+// Persistent cache of results - every entry is a file in the cache directory, named after the hash of its key.
+// Entries are evicted in LRU order when the total size exceeds the limit; the order survives restarts because
+// the modification time of an entry is set when it is stored and on every hit. The index of entries is built when
+// the cache is opened and rebuilt from the directory before evicting, so processes sharing a directory share its limit.
+class ResultCache
+{
+public:
+    struct Counters
+    {
+        std::uint64_t hits = 0;
+        std::uint64_t misses = 0;
+        std::uint64_t evictions = 0;
+    };
+
+    static constexpr std::uint64_t default_size_limit = 64 * 1024 * 1024;
+
+private:
+    struct Entry
+    {
+        std::string name;
+        std::uint64_t size;
+    };
+
+    std::filesystem::path directory_;
+    std::uint64_t size_limit_;
+    std::uint64_t size_ = 0;
+    std::list<Entry> entries_; // most recently used first
+    std::unordered_map<std::string, std::list<Entry>::iterator> index_;
+    Counters counters_;
+    mutable std::mutex mutex_;
+
+    static constexpr std::string_view extension = ".result";
+
+    // unique in all processes sharing the directory - writers of the same entry never share a temporary file
+    static std::string temporary_name(const std::string& name)
+    {
+        static std::atomic<std::uint64_t> counter{0};
+#ifdef _WIN32
+        const auto pid = ::_getpid();
+#else
+        const auto pid = ::getpid();
+#endif
+        return name + "." + std::to_string(pid) + "." + std::to_string(counter++) + ".tmp";
+    }
+
+    static std::string entry_name(const std::string& key)
+    {
+        static constexpr char digits[] = "0123456789abcdef";
+
+        std::uint64_t hash = BinaryFormat::checksum(key.data(), key.size());
+        std::string name(16, '0');
+        for (auto it = name.rbegin(); it != name.rend(); ++it, hash >>= 4)
+            *it = digits[hash & 0xf];
+        return name + std::string(extension);
+    }
+
+    void remove(std::list<Entry>::iterator entry)
+    {
+        std::error_code ec;
+        std::filesystem::remove(directory_ / entry->name, ec);
+        size_ -= entry->size;
+        index_.erase(entry->name);
+        entries_.erase(entry);
+    }
+
+    void evict()
+    {
+        while (size_ > size_limit_ && !entries_.empty())
+        {
+            remove(std::prev(entries_.end()));
+            ++counters_.evictions;
+        }
+    }
+
+    void touch(std::list<Entry>::iterator entry)
+    {
+        entries_.splice(entries_.begin(), entries_, entry);
+
+        std::error_code ec;
+        std::filesystem::last_write_time(directory_ / entry->name, std::filesystem::file_time_type::clock::now(), ec);
+    }
+
+    // rebuilds the index from entries in the directory, most recently used (modified) first -
+    // entries added or removed by other processes are skipped over when they change during the scan
+    void scan()
+    {
+        std::vector<std::pair<std::filesystem::file_time_type, Entry>> found;
+        for (const auto& file : std::filesystem::directory_iterator{directory_})
+        {
+            std::error_code ec;
+            if (!file.is_regular_file(ec) || file.path().extension() != extension)
+                continue;
+
+            const auto time = file.last_write_time(ec);
+            const auto size = ec ? 0 : file.file_size(ec);
+            if (!ec)
+                found.emplace_back(time, Entry{file.path().filename().string(), size});
+        }
+
+        std::sort(found.begin(), found.end(), [](const auto& a, const auto& b) { return a.first > b.first; });
+
+        entries_.clear();
+        index_.clear();
+        size_ = 0;
+        for (auto& [time, entry] : found)
+        {
+            size_ += entry.size;
+            entries_.push_back(std::move(entry));
+            index_.emplace(entries_.back().name, std::prev(entries_.end()));
+        }
+    }
+
+public:
+    explicit ResultCache(std::filesystem::path directory, std::uint64_t size_limit = default_size_limit)
+        : directory_{std::move(directory)}
+        , size_limit_{size_limit}
+    {
+        std::filesystem::create_directories(directory_);
+
+        scan();
+        evict();
+    }
+
+    ResultCache(const ResultCache&) = delete;
+    ResultCache& operator=(const ResultCache&) = delete;
+
+    // Identity of the current content of a file: canonical path, size and modification time,
+    // with hash_content also a checksum of the content (detects changes that keep size and time)
+    static std::string file_identity(const std::string& file_name, bool hash_content = false)
+    {
+        const auto path = std::filesystem::canonical(file_name);
+
+        StateWriter identity{"FileIdentity"};
+        identity.write(path.string());
+        identity.write(static_cast<std::uint64_t>(std::filesystem::file_size(path)));
+        identity.write(static_cast<std::int64_t>(std::filesystem::last_write_time(path).time_since_epoch().count()));
+        if (hash_content)
+        {
+            MappedFile file{path.string()};
+            identity.write(BinaryFormat::checksum(file.data(), file.size()));
+        }
+        return identity.str();
+    }
+
+    std::optional<Results> find(const std::string& key)
+    {
+        std::lock_guard lock{mutex_};
+
+        auto entry = index_.find(entry_name(key));
+        if (entry == index_.end())
+        {
+            ++counters_.misses;
+            return std::nullopt;
+        }
+
+        try
+        {
+            std::ifstream in{directory_ / entry->second->name, std::ios::binary};
+            std::string bytes{std::istreambuf_iterator<char>{in}, std::istreambuf_iterator<char>{}};
+
+            StateReader state{bytes, "ResultCacheEntry"};
+            if (state.read_text() != key) // hash collision
+            {
+                ++counters_.misses;
+                return std::nullopt;
+            }
+
+            Results results;
+            for (auto count = state.read<std::uint64_t>(); count > 0; --count)
+            {
+                std::string description{state.read_text()};
+                results.push_back(StatResult(description, state.read<double>()));
+            }
+            state.expect_end();
+
+            touch(entry->second);
+            ++counters_.hits;
+            return results;
+        }
+        catch (const std::exception&) // entry removed or damaged outside of this cache
+        {
+            remove(entry->second);
+            ++counters_.misses;
+            return std::nullopt;
+        }
+    }
+
+    void store(const std::string& key, const Results& results)
+    {
+        StateWriter state{"ResultCacheEntry"};
+        state.write(std::string_view{key});
+        state.write(static_cast<std::uint64_t>(results.size()));
+        for (const auto& result : results)
+        {
+            state.write(std::string_view{result.description});
+            state.write(result.value);
+        }
+        const std::string bytes = state.str();
+
+        std::lock_guard lock{mutex_};
+
+        if (bytes.size() > size_limit_)
+            return;
+
+        // entry is written to a temporary file of its own and renamed into place,
+        // so other processes never read a partially written one
+        const std::string name = entry_name(key);
+        const auto path = directory_ / name;
+        const auto temporary_path = directory_ / temporary_name(name);
+        {
+            std::ofstream out{temporary_path, std::ios::binary};
+            out.write(bytes.data(), bytes.size());
+            if (!out)
+            {
+                out.close();
+                std::error_code ec;
+                std::filesystem::remove(temporary_path, ec);
+                throw std::runtime_error("File not written!!!");
+            }
+        }
+        std::filesystem::rename(temporary_path, path);
+
+        // time of kernel timestamps can be coarser than the order of stores
+        std::error_code ec;
+        std::filesystem::last_write_time(path, std::filesystem::file_time_type::clock::now(), ec);
+
+        auto entry = index_.find(name);
+        if (entry != index_.end())
+        {
+            size_ -= entry->second->size;
+            entries_.erase(entry->second);
+            index_.erase(entry);
+        }
+        entries_.push_front(Entry{name, bytes.size()});
+        index_.emplace(name, entries_.begin());
+        size_ += bytes.size();
+
+        // entries stored by other processes count against the limit too - the directory is scanned
+        // only when the limit is exceeded, so a series of stores does not walk it every time
+        if (size_ > size_limit_)
+        {
+            scan();
+            evict();
+        }
+    }
+
+    void clear()
+    {
+        std::lock_guard lock{mutex_};
+
+        while (!entries_.empty())
+            remove(entries_.begin());
+    }
+
+    Counters counters() const
+    {
+        std::lock_guard lock{mutex_};
+        return counters_;
+    }
+
+    // total size of entries in bytes
+    std::uint64_t size() const
+    {
+        std::lock_guard lock{mutex_};
+        return size_;
+    }
+
+    std::size_t entry_count() const
+    {
+        std::lock_guard lock{mutex_};
+        return entries_.size();
+    }
+};
+
+namespace Ver_2
+{
+    // DataAnalyzer that looks up results of its statistics for the current content of a file in ResultCache
+    // and loads the file only on a miss. All analyzers sharing a cache directory should use the same reader.
+    class CachedDataAnalyzer
+    {
+        std::vector<std::shared_ptr<IStatistics>> stats_;
+        std::shared_ptr<ResultCache> cache_;
+        bool hash_content_;
+        Results results_;
+        DataReader reader_;
+        DataWriter writer_;
+
+    public:
+        CachedDataAnalyzer(std::vector<std::shared_ptr<IStatistics>> stats, std::shared_ptr<ResultCache> cache, bool hash_content = false,
+            DataReader reader = text_reader, DataWriter writer = text_writer)
+            : stats_{std::move(stats)}
+            , cache_{std::move(cache)}
+            , hash_content_{hash_content}
+            , reader_{reader}
+            , writer_{writer}
+        {
+        }
+
+        void set_statistics(std::vector<std::shared_ptr<IStatistics>> stats)
+        {
+            stats_ = std::move(stats);
+        }
+
+        std::string key(const std::string& file_name) const
+        {
+            StateWriter key{"ResultCacheKey"};
+            key.write(std::string_view{ResultCache::file_identity(file_name, hash_content_)});
+            for (const auto& stat : stats_)
+                key.write(std::string_view{stat->kind()});
+            return key.str();
+        }
+
+        void calculate(const std::string& file_name)
+        {
+            const std::string cache_key = key(file_name);
+
+            std::optional<Results> current_results = cache_->find(cache_key);
+            if (!current_results)
+            {
+                current_results = calculate_fused(stats_, reader_(file_name));
+                cache_->store(cache_key, *current_results);
+            }
+
+            results_.insert(results_.end(), current_results->begin(), current_results->end());
+        }
+
+        void clear_results()
+        {
+            results_.clear();
+        }
+
+        const Results& results() const
+        {
+            return results_;
+        }
+
+        void save_results(const std::string& file_name)
+        {
+            writer_(file_name, results_);
+        }
+
+        const ResultCache& cache() const
+        {
+            return *cache_;
+        }
+    };
+}
+
+#endif // RESULT_CACHE_HPP
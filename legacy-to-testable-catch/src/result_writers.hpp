@@ -0,0 +1,290 @@
+#ifndef RESULT_WRITERS_HPP
+#define RESULT_WRITERS_HPP
+
+#include "data_analyzer.hpp"
+#include "mapped_file.hpp"
+
+#include <algorithm>
+#include <charconv>
+#include <climits>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <initializer_list>
+#include <span>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#ifndef _WIN32
+#include <cerrno>
+#include <fcntl.h>
+#include <sys/uio.h>
+#include <unistd.h>
+#endif
+
+// Output of result writers is formatted into memory and written to the file at once -
+// no stream formatting and no flushes per result
+class OutputBuffer
+{
+    std::string bytes_;
+
+public:
+    explicit OutputBuffer(std::size_t capacity = 0)
+    {
+        bytes_.reserve(capacity);
+    }
+
+    void append(std::string_view text)
+    {
+        bytes_.append(text);
+    }
+
+    void append(char c)
+    {
+        bytes_.push_back(c);
+    }
+
+    // shortest representation that reads back as the same value ("nan", "inf" and "-inf" for special values)
+    void append_number(double value)
+    {
+        char digits[32];
+        auto [end, ec] = std::to_chars(digits, digits + sizeof(digits), value);
+        bytes_.append(digits, end);
+    }
+
+    template <typename T>
+    void append_raw(const T& value)
+    {
+        bytes_.append(reinterpret_cast<const char*>(&value), sizeof(value));
+    }
+
+    std::string_view view() const
+    {
+        return bytes_;
+    }
+
+    std::size_t size() const
+    {
+        return bytes_.size();
+    }
+};
+
+// Writes parts one after another to a new file - with a single writev on POSIX systems
+inline void write_file(const std::string& file_name, std::initializer_list<std::string_view> parts)
+{
+#ifndef _WIN32
+    int fd = ::open(file_name.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+    if (fd == -1)
+        throw std::runtime_error("File not opened!!!");
+
+    std::vector<iovec> pending;
+    for (std::string_view part : parts)
+        if (!part.empty())
+            pending.push_back(iovec{const_cast<char*>(part.data()), part.size()});
+
+    std::size_t first = 0;
+    while (first < pending.size()) // writev can write less than requested
+    {
+        ssize_t written = ::writev(fd, pending.data() + first, static_cast<int>(std::min<std::size_t>(pending.size() - first, IOV_MAX)));
+        if (written < 0)
+        {
+            if (errno == EINTR)
+                continue;
+            ::close(fd);
+            throw std::runtime_error("File not written!!!");
+        }
+
+        auto bytes = static_cast<std::size_t>(written);
+        for (; first < pending.size() && bytes >= pending[first].iov_len; ++first)
+            bytes -= pending[first].iov_len;
+        if (first < pending.size())
+        {
+            pending[first].iov_base = static_cast<char*>(pending[first].iov_base) + bytes;
+            pending[first].iov_len -= bytes;
+        }
+    }
+
+    if (::close(fd) == -1)
+        throw std::runtime_error("File not written!!!");
+#else
+    std::ofstream out{file_name, std::ios::binary};
+    if (!out)
+        throw std::runtime_error("File not opened!!!");
+
+    for (std::string_view part : parts)
+        out.write(part.data(), static_cast<std::streamsize>(part.size()));
+
+    if (!out)
+        throw std::runtime_error("File not written!!!");
+#endif
+}
+
+namespace ResultFormats
+{
+    // binary records layout (little-endian): magic "TDRS", uint32 version, uint64 count,
+    // count x (uint32 description size, description bytes, IEEE-754 double value)
+    inline constexpr char magic[4] = {'T', 'D', 'R', 'S'};
+    inline constexpr std::uint32_t version = 1;
+
+    // RFC 4180 - fields with separators, quotes or line breaks are quoted
+    inline void append_csv_field(OutputBuffer& out, std::string_view text)
+    {
+        if (text.find_first_of(",\"\r\n") == std::string_view::npos)
+        {
+            out.append(text);
+            return;
+        }
+
+        out.append('"');
+        for (char c : text)
+        {
+            if (c == '"')
+                out.append('"');
+            out.append(c);
+        }
+        out.append('"');
+    }
+
+    inline void append_json_string(OutputBuffer& out, std::string_view text)
+    {
+        static constexpr char hex[] = "0123456789abcdef";
+
+        out.append('"');
+        for (char c : text)
+        {
+            switch (c)
+            {
+            case '"':
+                out.append("\\\"");
+                break;
+            case '\\':
+                out.append("\\\\");
+                break;
+            case '\n':
+                out.append("\\n");
+                break;
+            case '\r':
+                out.append("\\r");
+                break;
+            case '\t':
+                out.append("\\t");
+                break;
+            default:
+                if (static_cast<unsigned char>(c) < 0x20)
+                {
+                    out.append("\\u00");
+                    out.append(hex[c >> 4]);
+                    out.append(hex[c & 0xf]);
+                }
+                else
+                {
+                    out.append(c);
+                }
+            }
+        }
+        out.append('"');
+    }
+}
+
+// "description,value" with a header line
+inline void csv_writer(const std::string& file_name, const Results& results)
+{
+    OutputBuffer out{results.size() * 32};
+    out.append("description,value\n");
+    for (const auto& result : results)
+    {
+        ResultFormats::append_csv_field(out, result.description);
+        out.append(',');
+        out.append_number(result.value);
+        out.append('\n');
+    }
+
+    write_file(file_name, {out.view()});
+}
+
+// One JSON object per line: {"description":"Avg","value":47.15} - NaN and infinities are written as null
+inline void json_lines_writer(const std::string& file_name, const Results& results)
+{
+    OutputBuffer out{results.size() * 48};
+    for (const auto& result : results)
+    {
+        out.append("{\"description\":");
+        ResultFormats::append_json_string(out, result.description);
+        out.append(",\"value\":");
+        if (std::isfinite(result.value))
+            out.append_number(result.value);
+        else
+            out.append("null");
+        out.append("}\n");
+    }
+
+    write_file(file_name, {out.view()});
+}
+
+inline void binary_results_writer(const std::string& file_name, const Results& results)
+{
+    using namespace ResultFormats;
+
+    OutputBuffer header;
+    header.append(std::string_view{magic, sizeof(magic)});
+    header.append_raw(version);
+    header.append_raw(static_cast<std::uint64_t>(results.size()));
+
+    OutputBuffer records{results.size() * 24};
+    for (const auto& result : results)
+    {
+        records.append_raw(static_cast<std::uint32_t>(result.description.size()));
+        records.append(result.description);
+        records.append_raw(result.value);
+    }
+
+    write_file(file_name, {header.view(), records.view()});
+}
+
+inline Results binary_results_reader(const std::string& file_name)
+{
+    using namespace ResultFormats;
+
+    MappedFile file{file_name};
+    std::string_view bytes = file.view();
+
+    auto read = [&bytes](void* target, std::size_t size) {
+        if (bytes.size() < size)
+            throw std::runtime_error("Invalid binary results file!!!");
+        std::memcpy(target, bytes.data(), size);
+        bytes.remove_prefix(size);
+    };
+
+    char file_magic[sizeof(magic)];
+    std::uint32_t file_version;
+    std::uint64_t count;
+    read(file_magic, sizeof(file_magic));
+    read(&file_version, sizeof(file_version));
+    read(&count, sizeof(count));
+    if (std::memcmp(file_magic, magic, sizeof(magic)) != 0 || file_version != version)
+        throw std::runtime_error("Invalid binary results file!!!");
+
+    Results results;
+    for (; count > 0; --count)
+    {
+        std::uint32_t size;
+        read(&size, sizeof(size));
+        if (bytes.size() < size)
+            throw std::runtime_error("Invalid binary results file!!!");
+        std::string description(size, '\0');
+        read(description.data(), size);
+        double value;
+        read(&value, sizeof(value));
+        results.push_back(StatResult(description, value));
+    }
+
+    if (!bytes.empty())
+        throw std::runtime_error("Invalid binary results file!!!");
+
+    return results;
+}
+
+#endif // RESULT_WRITERS_HPP
@@ -0,0 +1,287 @@
+#ifndef ROLLING_STATISTICS_HPP
+#define ROLLING_STATISTICS_HPP
+
+#include "data_analyzer.hpp"
+#include "stream_reader.hpp"
+
+#include <bit>
+#include <charconv>
+#include <cmath>
+#include <fstream>
+#include <functional>
+#include <limits>
+#include <span>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+namespace Ver_2
+{
+    // statistics of the window of samples [index + 1 - window size, index]
+    struct RollingValues
+    {
+        std::size_t index;
+        double sum;
+        double mean;
+        double min;
+        double max;
+
+        bool operator==(const RollingValues&) const = default;
+    };
+
+    using RollingConsumer = std::function<void(std::span<const RollingValues>)>;
+
+    // Queue of window values where max (Compare = std::greater) or min (std::less) is always at the front:
+    // a new value removes all values it beats from the back, so every value is pushed and popped once.
+    template <typename Compare>
+    class MonotonicQueue
+    {
+        struct Item
+        {
+            std::size_t index;
+            double value;
+        };
+
+        std::vector<Item> items_; // ring buffer with power-of-two size - a window never holds more values
+        std::size_t mask_;
+        std::size_t head_ = 0; // positions grow monotonically and are masked on access
+        std::size_t tail_ = 0;
+
+    public:
+        explicit MonotonicQueue(std::size_t capacity)
+            : items_(std::bit_ceil(capacity))
+            , mask_{items_.size() - 1}
+        {
+        }
+
+        void clear()
+        {
+            head_ = tail_ = 0;
+        }
+
+        void push(std::size_t index, double value)
+        {
+            while (tail_ != head_ && !Compare{}(items_[(tail_ - 1) & mask_].value, value))
+                --tail_;
+            items_[tail_++ & mask_] = Item{index, value};
+        }
+
+        // removes values with index below first_index
+        void expire(std::size_t first_index)
+        {
+            while (tail_ != head_ && items_[head_ & mask_].index < first_index)
+                ++head_;
+        }
+
+        double front() const
+        {
+            return tail_ == head_ ? std::numeric_limits<double>::quiet_NaN() : items_[head_ & mask_].value;
+        }
+    };
+
+    // Rolling sum, mean, min and max over a window of N samples in O(1) amortized time per sample.
+    // A row is produced for every sample that completes a window; rows are passed to consumer in batches.
+    // NaN samples are skipped by min and max and make sum and mean NaN while they are in the window.
+    // Infinite samples are counted instead of added, so sum and mean are +-inf (NaN for both signs) only while they are in the window.
+    class RollingStatistics
+    {
+        std::size_t window_size_;
+        std::vector<double> window_; // ring buffer of the last window_size_ samples
+        std::size_t count_ = 0;
+        std::size_t position_ = 0; // slot of the oldest sample in window_
+        double sum_ = 0.0;
+        double compensation_ = 0.0; // Neumaier compensation - the sum does not drift over long series
+        std::size_t nan_count_ = 0;
+        std::size_t pos_inf_count_ = 0;
+        std::size_t neg_inf_count_ = 0;
+        MonotonicQueue<std::greater<>> max_;
+        MonotonicQueue<std::less<>> min_;
+        std::vector<RollingValues> rows_;
+
+        // value must be finite - inf - inf would make the compensation NaN for good
+        void add(double value)
+        {
+            const double t = sum_ + value;
+            compensation_ += std::abs(sum_) >= std::abs(value) ? (sum_ - t) + value : (value - t) + sum_;
+            sum_ = t;
+        }
+
+        double window_sum() const
+        {
+            if (nan_count_ > 0 || (pos_inf_count_ > 0 && neg_inf_count_ > 0))
+                return std::numeric_limits<double>::quiet_NaN();
+            if (pos_inf_count_ > 0)
+                return std::numeric_limits<double>::infinity();
+            if (neg_inf_count_ > 0)
+                return -std::numeric_limits<double>::infinity();
+            return sum_ + compensation_;
+        }
+
+    public:
+        static constexpr std::size_t batch_size = 4096;
+
+        explicit RollingStatistics(std::size_t window_size)
+            : window_size_{window_size}
+            , window_(window_size)
+            , max_{window_size}
+            , min_{window_size}
+        {
+            if (window_size_ == 0)
+                throw std::invalid_argument("Window size must be positive!!!");
+
+            rows_.reserve(batch_size);
+        }
+
+        std::size_t window_size() const
+        {
+            return window_size_;
+        }
+
+        void clear()
+        {
+            count_ = position_ = nan_count_ = pos_inf_count_ = neg_inf_count_ = 0;
+            sum_ = compensation_ = 0.0;
+            max_.clear();
+            min_.clear();
+        }
+
+        void update(std::span<const double> values, const RollingConsumer& consume)
+        {
+            for (double value : values)
+            {
+                const std::size_t index = count_++;
+                double& slot = window_[position_];
+                if (++position_ == window_size_)
+                    position_ = 0;
+
+                if (index >= window_size_)
+                {
+                    if (std::isnan(slot))
+                        --nan_count_;
+                    else if (std::isinf(slot))
+                        --(slot > 0 ? pos_inf_count_ : neg_inf_count_);
+                    else
+                        add(-slot);
+                }
+
+                // expired values are removed first, so queues never hold more than window_size_ values
+                const std::size_t first_index = count_ > window_size_ ? count_ - window_size_ : 0;
+                max_.expire(first_index);
+                min_.expire(first_index);
+
+                slot = value;
+                if (std::isnan(value))
+                {
+                    ++nan_count_;
+                }
+                else
+                {
+                    if (std::isinf(value))
+                        ++(value > 0 ? pos_inf_count_ : neg_inf_count_);
+                    else
+                        add(value);
+                    max_.push(index, value);
+                    min_.push(index, value);
+                }
+
+                if (count_ < window_size_)
+                    continue;
+
+                const double sum = window_sum();
+                rows_.push_back(RollingValues{index, sum, sum / window_size_, min_.front(), max_.front()});
+
+                if (rows_.size() == batch_size)
+                {
+                    consume(rows_);
+                    rows_.clear();
+                }
+            }
+
+            if (!rows_.empty())
+            {
+                consume(rows_);
+                rows_.clear();
+            }
+        }
+    };
+
+    // Writes rolling series as CSV ("Index,Sum,Mean,Min,Max") - rows are formatted with to_chars into a buffer
+    // that is written to file in large blocks
+    class RollingSeriesWriter
+    {
+        std::ofstream fout_;
+        std::string buffer_;
+
+        void append(double value)
+        {
+            char text[32];
+            auto [ptr, ec] = std::to_chars(std::begin(text), std::end(text), value);
+            buffer_.append(text, ptr);
+        }
+
+    public:
+        static constexpr std::size_t flush_size = 1024 * 1024;
+
+        explicit RollingSeriesWriter(const std::string& file_name)
+            : fout_{file_name, std::ios::binary}
+        {
+            if (!fout_)
+                throw std::runtime_error("File not opened!!!");
+
+            buffer_.reserve(flush_size + 256);
+            buffer_ += "Index,Sum,Mean,Min,Max\n";
+        }
+
+        RollingSeriesWriter(const RollingSeriesWriter&) = delete;
+        RollingSeriesWriter& operator=(const RollingSeriesWriter&) = delete;
+
+        // errors are reported only by flush() - rolling_statistics() calls it explicitly
+        ~RollingSeriesWriter()
+        {
+            fout_.write(buffer_.data(), buffer_.size());
+        }
+
+        void write(std::span<const RollingValues> rows)
+        {
+            for (const auto& row : rows)
+            {
+                char text[24];
+                auto [ptr, ec] = std::to_chars(std::begin(text), std::end(text), row.index);
+                buffer_.append(text, ptr);
+                for (double value : {row.sum, row.mean, row.min, row.max})
+                {
+                    buffer_ += ',';
+                    append(value);
+                }
+                buffer_ += '\n';
+
+                if (buffer_.size() >= flush_size)
+                    flush();
+            }
+        }
+
+        void flush()
+        {
+            fout_.write(buffer_.data(), buffer_.size());
+            fout_.flush();
+            buffer_.clear();
+
+            if (!fout_)
+                throw std::runtime_error("File not written!!!");
+        }
+    };
+
+    // Streams data file through rolling window and writes the series to output_file
+    inline void rolling_statistics(const std::string& file_name, const std::string& output_file, std::size_t window_size,
+        const DataStreamReader& reader = text_stream_reader)
+    {
+        RollingStatistics rolling{window_size};
+        RollingSeriesWriter writer{output_file};
+
+        auto write = [&writer](std::span<const RollingValues> rows) { writer.write(rows); };
+        reader(file_name, [&](std::span<const double> values) { rolling.update(values, write); });
+        writer.flush();
+    }
+}
+
+#endif // ROLLING_STATISTICS_HPP
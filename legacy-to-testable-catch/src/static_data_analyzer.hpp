@@ -0,0 +1,271 @@
+#ifndef STATIC_DATA_ANALYZER_HPP
+#define STATIC_DATA_ANALYZER_HPP
+
+#include "data_analyzer.hpp"
+#include "kernels.hpp"
+
+#include <algorithm>
+#include <array>
+#include <limits>
+#include <span>
+#include <string>
+#include <string_view>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+
+namespace Ver_2
+{
+    // Compile-time counterparts of statistics - data is split into blocks of fused_block_size like in calculate_fused,
+    // and every block is reduced in groups of Kernels::lane_count values in the order documented in kernels.hpp,
+    // so results are bit-identical to those of DataAnalyzer::calculate. Statistics with the same State (Avg and Sum) share it.
+    namespace StaticStatistics
+    {
+        constexpr std::size_t lane_count = Kernels::lane_count;
+
+        template <typename Statistic>
+        struct Kernel;
+
+        struct SumLanes
+        {
+            double lanes[lane_count];
+            double sum = 0.0; // of finished blocks
+
+            void begin_block(std::span<const double>)
+            {
+                std::fill(std::begin(lanes), std::end(lanes), 0.0);
+            }
+
+            void update(const double* values)
+            {
+                for (std::size_t j = 0; j < lane_count; ++j)
+                    lanes[j] = lanes[j] + values[j];
+            }
+
+            void update_tail(std::span<const double> tail)
+            {
+                for (std::size_t j = 0; j < tail.size(); ++j)
+                    lanes[j] = lanes[j] + tail[j];
+            }
+
+            void end_block()
+            {
+                for (std::size_t w = lane_count / 2; w > 0; w /= 2)
+                    for (std::size_t j = 0; j < w; ++j)
+                        lanes[j] = lanes[j + w] + lanes[j];
+                sum += lanes[0];
+            }
+        };
+
+        template <>
+        struct Kernel<Sum>
+        {
+            using State = SumLanes;
+            static constexpr std::array<std::string_view, 1> descriptions = {"Sum"};
+
+            static void finalize(const State& state, std::size_t, double* out)
+            {
+                out[0] = state.sum;
+            }
+        };
+
+        template <>
+        struct Kernel<Avg>
+        {
+            using State = SumLanes;
+            static constexpr std::array<std::string_view, 1> descriptions = {"Avg"};
+
+            static void finalize(const State& state, std::size_t count, double* out)
+            {
+                out[0] = state.sum / count;
+            }
+        };
+
+        template <>
+        struct Kernel<MinMax>
+        {
+            struct State
+            {
+                double min_lanes[lane_count];
+                double max_lanes[lane_count];
+                double min = std::numeric_limits<double>::quiet_NaN();
+                double max = std::numeric_limits<double>::quiet_NaN();
+                bool empty = true;
+
+                void begin_block(std::span<const double> block)
+                {
+                    std::fill(std::begin(min_lanes), std::end(min_lanes), block[0]);
+                    std::fill(std::begin(max_lanes), std::end(max_lanes), block[0]);
+                }
+
+                void update(const double* values)
+                {
+                    for (std::size_t j = 0; j < lane_count; ++j)
+                    {
+                        min_lanes[j] = values[j] < min_lanes[j] ? values[j] : min_lanes[j];
+                        max_lanes[j] = values[j] > max_lanes[j] ? values[j] : max_lanes[j];
+                    }
+                }
+
+                void update_tail(std::span<const double> tail)
+                {
+                    for (std::size_t j = 0; j < tail.size(); ++j)
+                    {
+                        min_lanes[j] = tail[j] < min_lanes[j] ? tail[j] : min_lanes[j];
+                        max_lanes[j] = tail[j] > max_lanes[j] ? tail[j] : max_lanes[j];
+                    }
+                }
+
+                // minimum and maximum of blocks are combined like in MinMax::Accumulator
+                void end_block()
+                {
+                    for (std::size_t w = lane_count / 2; w > 0; w /= 2)
+                        for (std::size_t j = 0; j < w; ++j)
+                        {
+                            min_lanes[j] = min_lanes[j + w] < min_lanes[j] ? min_lanes[j + w] : min_lanes[j];
+                            max_lanes[j] = max_lanes[j + w] > max_lanes[j] ? max_lanes[j + w] : max_lanes[j];
+                        }
+
+                    if (empty || min_lanes[0] < min)
+                        min = min_lanes[0];
+                    if (empty || max_lanes[0] > max)
+                        max = max_lanes[0];
+                    empty = false;
+                }
+            };
+
+            static constexpr std::array<std::string_view, 2> descriptions = {"Min", "Max"};
+
+            static void finalize(const State& state, std::size_t, double* out)
+            {
+                out[0] = state.min;
+                out[1] = state.max;
+            }
+        };
+
+        // std::tuple of distinct types from Ts...
+        template <typename Tuple, typename... Ts>
+        struct UniqueTypes
+        {
+            using type = Tuple;
+        };
+
+        template <typename... Us, typename T, typename... Ts>
+        struct UniqueTypes<std::tuple<Us...>, T, Ts...>
+            : std::conditional_t<(std::is_same_v<T, Us> || ...), UniqueTypes<std::tuple<Us...>, Ts...>, UniqueTypes<std::tuple<Us..., T>, Ts...>>
+        {
+        };
+    }
+
+    // Statistics selected at compile time are fused into one loop without virtual calls or allocations,
+    // e.g. StaticDataAnalyzer<Avg, MinMax, Sum>
+    template <typename... Statistics>
+    class StaticDataAnalyzer
+    {
+        template <typename Statistic>
+        using KernelOf = StaticStatistics::Kernel<Statistic>;
+
+    public:
+        static constexpr std::size_t result_count = (KernelOf<Statistics>::descriptions.size() + ...);
+
+        using Values = std::array<double, result_count>;
+
+        // one state per distinct State type of kernels
+        using States = typename StaticStatistics::UniqueTypes<std::tuple<>, typename KernelOf<Statistics>::State...>::type;
+
+        static constexpr std::array<std::string_view, result_count> descriptions = [] {
+            std::array<std::string_view, result_count> all{};
+            std::size_t i = 0;
+            ((std::copy(KernelOf<Statistics>::descriptions.begin(), KernelOf<Statistics>::descriptions.end(), all.begin() + i),
+                 i += KernelOf<Statistics>::descriptions.size()),
+                ...);
+            return all;
+        }();
+
+    private:
+        Data data_;
+        Values values_{};
+        DataReader reader_;
+        DataWriter writer_;
+
+        static constexpr std::array<std::size_t, sizeof...(Statistics)> offsets_ = [] {
+            std::array<std::size_t, sizeof...(Statistics)> offsets{};
+            std::size_t sizes[] = {KernelOf<Statistics>::descriptions.size()...};
+            for (std::size_t i = 1; i < offsets.size(); ++i)
+                offsets[i] = offsets[i - 1] + sizes[i - 1];
+            return offsets;
+        }();
+
+        template <std::size_t... I>
+        static Values calculate(std::span<const double> data, std::index_sequence<I...>)
+        {
+            States states;
+            for (std::size_t offset = 0; offset < data.size(); offset += fused_block_size)
+            {
+                auto block = data.subspan(offset, std::min(fused_block_size, data.size() - offset));
+                std::apply(
+                    [block](auto&... state) {
+                        (state.begin_block(block), ...);
+
+                        const std::size_t n = block.size() - block.size() % StaticStatistics::lane_count;
+                        for (std::size_t i = 0; i < n; i += StaticStatistics::lane_count)
+                            (state.update(block.data() + i), ...);
+
+                        (state.update_tail(block.subspan(n)), ...);
+                        (state.end_block(), ...);
+                    },
+                    states);
+            }
+
+            Values values;
+            (KernelOf<Statistics>::finalize(std::get<typename KernelOf<Statistics>::State>(states), data.size(), values.data() + offsets_[I]), ...);
+            return values;
+        }
+
+    public:
+        explicit StaticDataAnalyzer(DataReader reader = text_reader, DataWriter writer = text_writer)
+            : reader_{reader}
+            , writer_{writer}
+        {
+        }
+
+        static Values calculate(std::span<const double> data)
+        {
+            return calculate(data, std::index_sequence_for<Statistics...>{});
+        }
+
+        void load_data(const std::string& file_name)
+        {
+            data_ = reader_(file_name);
+            values_ = {};
+
+            std::cout << "File " << file_name << " has been loaded...\n";
+        }
+
+        void calculate()
+        {
+            values_ = calculate(data_);
+        }
+
+        const Values& values() const
+        {
+            return values_;
+        }
+
+        Results results() const
+        {
+            Results results;
+            results.reserve(result_count);
+            for (std::size_t i = 0; i < result_count; ++i)
+                results.emplace_back(std::string{descriptions[i]}, values_[i]);
+            return results;
+        }
+
+        void save_results(const std::string& file_name)
+        {
+            writer_(file_name, results());
+        }
+    };
+}
+
+#endif // STATIC_DATA_ANALYZER_HPP
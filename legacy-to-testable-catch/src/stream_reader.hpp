@@ -0,0 +1,106 @@
+#ifndef STREAM_READER_HPP
+#define STREAM_READER_HPP
+
+#include "mmap_reader.hpp"
+
+#include <fstream>
+#include <functional>
+#include <span>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+
+using ChunkConsumer = std::function<void(std::span<const double>)>;
+using DataStreamReader = std::function<void(const std::string&, const ChunkConsumer&)>;
+
+// Parses text delivered block by block - next_block() returns the next block of text, an empty one at the end.
+// A number cut in half at the end of a block is parsed with the next block. Values are passed to consumer
+// in chunks of at most chunk_size. Like text_reader it stops at the first invalid token.
+template <typename BlockSource>
+void parse_text_blocks(BlockSource&& next_block, std::size_t chunk_size, const ChunkConsumer& consume)
+{
+    std::string text; // unparsed tail of previous block + current block
+    Data values;
+    values.reserve(chunk_size);
+
+    bool done = false;
+    while (!done)
+    {
+        const std::string_view block = next_block();
+        const bool end_of_file = block.empty();
+        text.append(block);
+
+        // number at the end of block can be cut in half - it is parsed after the next read
+        std::size_t parse_end = text.size();
+        if (!end_of_file)
+        {
+            auto last_separator = std::find_if(text.rbegin(), text.rend(), is_number_separator);
+            parse_end = static_cast<std::size_t>(text.rend() - last_separator);
+        }
+
+        std::string_view complete_text{text.data(), parse_end};
+        std::size_t pos = 0;
+        while (true)
+        {
+            pos += parse_numbers(complete_text.substr(pos), values, chunk_size - values.size());
+
+            if (values.size() == chunk_size)
+            {
+                consume(values);
+                values.clear();
+                continue;
+            }
+
+            if (pos < complete_text.size()) // like text_reader - stop at the first invalid token
+                done = true;
+            break;
+        }
+
+        text.erase(0, parse_end);
+        done = done || end_of_file;
+    }
+
+    if (!values.empty())
+        consume(values);
+}
+
+// Reads text file in fixed-size blocks and passes parsed values to consumer in chunks of at most chunk_size.
+// Memory used does not depend on the size of the file.
+class TextStreamReader
+{
+    std::size_t chunk_size_;
+    std::size_t block_size_;
+
+public:
+    static constexpr std::size_t default_chunk_size = 64 * 1024;
+    static constexpr std::size_t default_block_size = 1024 * 1024;
+
+    explicit TextStreamReader(std::size_t chunk_size = default_chunk_size, std::size_t block_size = default_block_size)
+        : chunk_size_{std::max<std::size_t>(chunk_size, 1)}
+        , block_size_{std::max<std::size_t>(block_size, 1)}
+    {
+    }
+
+    void operator()(const std::string& file_name, const ChunkConsumer& consume) const
+    {
+        std::ifstream fin(file_name, std::ios::binary);
+        if (!fin)
+            throw std::runtime_error("File not opened!!!");
+
+        std::string block(block_size_, '\0');
+        auto next_block = [&]() -> std::string_view {
+            fin.read(block.data(), block.size());
+            Metrics::add_bytes_read(static_cast<std::uint64_t>(fin.gcount()));
+            return {block.data(), static_cast<std::size_t>(fin.gcount())};
+        };
+
+        parse_text_blocks(next_block, chunk_size_, consume);
+    }
+};
+
+inline void text_stream_reader(const std::string& file_name, const ChunkConsumer& consume)
+{
+    TextStreamReader{}(file_name, consume);
+}
+
+#endif // STREAM_READER_HPP
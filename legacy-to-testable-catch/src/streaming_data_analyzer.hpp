@@ -0,0 +1,60 @@
+#ifndef STREAMING_DATA_ANALYZER_HPP
+#define STREAMING_DATA_ANALYZER_HPP
+
+#include "data_analyzer.hpp"
+#include "stream_reader.hpp"
+
+#include <memory>
+#include <string>
+
+namespace Ver_2
+{
+    // Calculates statistics chunk by chunk while the file is read - the whole dataset is never held in memory
+    class StreamingDataAnalyzer
+    {
+        std::shared_ptr<IStreamingStatistics> stat_type_;
+        Results results_;
+        DataStreamReader reader_;
+        DataWriter writer_;
+
+    public:
+        StreamingDataAnalyzer(std::shared_ptr<IStreamingStatistics> stat_type, DataStreamReader reader = text_stream_reader, DataWriter writer = text_writer)
+            : stat_type_{stat_type}
+            , reader_{reader}
+            , writer_{writer}
+        {
+        }
+
+        void set_statistics(std::shared_ptr<IStreamingStatistics> stat_type)
+        {
+            stat_type_ = stat_type;
+        }
+
+        void calculate(const std::string& file_name)
+        {
+            auto accumulator = stat_type_->make_accumulator();
+
+            reader_(file_name, [&accumulator](std::span<const double> values) { accumulator->update(values); });
+
+            Results current_results = accumulator->finalize();
+            results_.insert(results_.end(), current_results.begin(), current_results.end());
+        }
+
+        void clear_results()
+        {
+            results_.clear();
+        }
+
+        const Results& results() const
+        {
+            return results_;
+        }
+
+        void save_results(const std::string& file_name)
+        {
+            writer_(file_name, results_);
+        }
+    };
+}
+
+#endif // STREAMING_DATA_ANALYZER_HPP
@@ -0,0 +1,173 @@
+#ifndef WORK_STEALING_POOL_HPP
+#define WORK_STEALING_POOL_HPP
+
+#include <algorithm>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <utility>
+#include <vector>
+
+// Thread pool where every worker has its own queue: a worker takes its newest task first and, when its queue
+// is empty, steals the oldest task of another worker. Tasks submitted from outside are distributed round-robin,
+// tasks submitted by a worker go to its own queue. Exceptions thrown by tasks are rethrown by wait().
+class WorkStealingPool
+{
+    using Task = std::function<void()>;
+
+    struct Queue
+    {
+        std::mutex mutex;
+        std::deque<Task> tasks;
+    };
+
+    std::vector<std::unique_ptr<Queue>> queues_;
+    std::vector<std::thread> workers_;
+
+    std::mutex mutex_; // guards sleeping, waking and completion of tasks
+    std::condition_variable work_available_;
+    std::condition_variable all_done_;
+    std::size_t queued_ = 0;  // tasks in queues
+    std::size_t pending_ = 0; // tasks not finished yet
+    bool stopping_ = false;
+    std::exception_ptr error_;
+    std::size_t next_queue_ = 0;
+
+    static inline thread_local const WorkStealingPool* current_pool_ = nullptr;
+    static inline thread_local std::size_t current_worker_ = 0;
+
+    bool try_pop(std::size_t worker, Task& task)
+    {
+        {
+            auto& own = *queues_[worker];
+            std::lock_guard lock{own.mutex};
+            if (!own.tasks.empty())
+            {
+                task = std::move(own.tasks.back());
+                own.tasks.pop_back();
+                return true;
+            }
+        }
+
+        for (std::size_t i = 1; i < queues_.size(); ++i)
+        {
+            auto& victim = *queues_[(worker + i) % queues_.size()];
+            std::lock_guard lock{victim.mutex};
+            if (!victim.tasks.empty())
+            {
+                task = std::move(victim.tasks.front());
+                victim.tasks.pop_front();
+                return true;
+            }
+        }
+
+        return false;
+    }
+
+    void run(std::size_t worker)
+    {
+        current_pool_ = this;
+        current_worker_ = worker;
+
+        while (true)
+        {
+            {
+                std::unique_lock lock{mutex_};
+                work_available_.wait(lock, [this] { return queued_ > 0 || stopping_; });
+                if (queued_ == 0 && stopping_)
+                    return;
+            }
+
+            Task task;
+            if (!try_pop(worker, task))
+            {
+                std::this_thread::yield();
+                continue;
+            }
+
+            {
+                std::lock_guard lock{mutex_};
+                --queued_;
+            }
+
+            try
+            {
+                task();
+            }
+            catch (...)
+            {
+                std::lock_guard lock{mutex_};
+                if (!error_)
+                    error_ = std::current_exception();
+            }
+
+            std::lock_guard lock{mutex_};
+            if (--pending_ == 0)
+                all_done_.notify_all();
+        }
+    }
+
+public:
+    explicit WorkStealingPool(std::size_t thread_count = std::thread::hardware_concurrency())
+    {
+        thread_count = std::max<std::size_t>(thread_count, 1);
+        for (std::size_t i = 0; i < thread_count; ++i)
+            queues_.push_back(std::make_unique<Queue>());
+        for (std::size_t i = 0; i < thread_count; ++i)
+            workers_.emplace_back([this, i] { run(i); });
+    }
+
+    WorkStealingPool(const WorkStealingPool&) = delete;
+    WorkStealingPool& operator=(const WorkStealingPool&) = delete;
+
+    ~WorkStealingPool()
+    {
+        {
+            std::lock_guard lock{mutex_};
+            stopping_ = true;
+        }
+        work_available_.notify_all();
+
+        for (auto& worker : workers_)
+            worker.join();
+    }
+
+    std::size_t thread_count() const
+    {
+        return workers_.size();
+    }
+
+    void submit(Task task)
+    {
+        std::size_t queue;
+        {
+            std::lock_guard lock{mutex_};
+            queue = current_pool_ == this ? current_worker_ : next_queue_++ % queues_.size();
+            ++pending_;
+            ++queued_; // counted before it is queued - a woken worker retries until it finds the task
+        }
+
+        {
+            std::lock_guard lock{queues_[queue]->mutex};
+            queues_[queue]->tasks.push_back(std::move(task));
+        }
+        work_available_.notify_one();
+    }
+
+    // waits until all submitted tasks are finished - must not be called from a task
+    void wait()
+    {
+        std::unique_lock lock{mutex_};
+        all_done_.wait(lock, [this] { return pending_ == 0; });
+
+        if (error_)
+            std::rethrow_exception(std::exchange(error_, nullptr));
+    }
+};
+
+#endif // WORK_STEALING_POOL_HPP
@@ -0,0 +1,271 @@
+#ifndef ZONE_MAP_HPP
+#define ZONE_MAP_HPP
+
+#include "binary_file.hpp"
+#include "kernels.hpp"
+
+#include <algorithm>
+#include <bit>
+#include <cstdint>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <limits>
+#include <span>
+#include <stdexcept>
+#include <string>
+#include <system_error>
+#include <vector>
+
+#ifndef _WIN32
+#include <sys/stat.h>
+#endif
+
+// count, sum, min and max of a range of values (min and max are NaN for an empty range)
+struct ZoneSummary
+{
+    std::uint64_t count = 0;
+    double sum = 0.0;
+    double min = std::numeric_limits<double>::quiet_NaN();
+    double max = std::numeric_limits<double>::quiet_NaN();
+
+    void add(std::span<const double> values)
+    {
+        if (values.empty())
+            return;
+
+        auto [values_min, values_max] = Kernels::min_max(values);
+        merge(ZoneSummary{values.size(), Kernels::sum(values), values_min, values_max});
+    }
+
+    void merge(const ZoneSummary& other)
+    {
+        if (other.count == 0)
+            return;
+
+        if (count == 0 || other.min < min)
+            min = other.min;
+        if (count == 0 || other.max > max)
+            max = other.max;
+        sum += other.sum;
+        count += other.count;
+    }
+};
+
+// Identity of an indexed data file - size, modification time and inode (not known on Windows).
+// Changes of content that keep all three are not detected.
+struct ZoneMapSource
+{
+    std::uint64_t size = 0;
+    std::int64_t time = 0;
+    std::uint64_t inode = 0;
+
+    bool operator==(const ZoneMapSource&) const = default;
+};
+
+// Block index of a data series - summary of every block of block_size values. A range query scans only
+// the partial blocks at both ends of [begin, end) and combines summaries of the blocks in between.
+// Sidecar file layout (little-endian): magic "TDZM", uint32 version, uint32 block_size, uint64 count,
+// uint64 block_count, ZoneMapSource of data file, block_count x ZoneSummary.
+class ZoneMap
+{
+    std::uint32_t block_size_;
+    std::uint64_t count_;
+    ZoneMapSource source_;
+    std::vector<ZoneSummary> blocks_;
+
+    static constexpr char magic[4] = {'T', 'D', 'Z', 'M'};
+    static constexpr std::uint32_t version = 3;
+
+    static_assert(sizeof(ZoneSummary) == 32);
+    static_assert(sizeof(ZoneMapSource) == 24);
+    static_assert(std::endian::native == std::endian::little, "ZoneMap supports only little-endian hosts");
+
+    ZoneMap(std::uint32_t block_size, std::uint64_t count)
+        : block_size_{block_size}
+        , count_{count}
+    {
+    }
+
+public:
+    static constexpr std::uint32_t default_block_size = 64 * 1024;
+
+    // source - identity of the file data was loaded from (see source_of)
+    static ZoneMap build(std::span<const double> data, std::uint32_t block_size = default_block_size, ZoneMapSource source = {})
+    {
+        if (block_size == 0)
+            throw std::invalid_argument("Block size must be positive!!!");
+
+        ZoneMap zone_map{block_size, data.size()};
+        zone_map.source_ = source;
+        zone_map.blocks_.reserve((data.size() + block_size - 1) / block_size);
+        for (std::size_t first = 0; first < data.size(); first += block_size)
+            zone_map.blocks_.emplace_back().add(data.subspan(first, std::min<std::size_t>(block_size, data.size() - first)));
+
+        return zone_map;
+    }
+
+    std::uint32_t block_size() const
+    {
+        return block_size_;
+    }
+
+    // number of values in indexed data
+    std::uint64_t count() const
+    {
+        return count_;
+    }
+
+    const std::vector<ZoneSummary>& blocks() const
+    {
+        return blocks_;
+    }
+
+    // identity of a data file - only a stat of the file, its content is not read (empty if the file is not found)
+    static ZoneMapSource source_of(const std::string& data_file_name)
+    {
+        std::error_code ec;
+        ZoneMapSource source;
+        source.size = std::filesystem::file_size(data_file_name, ec);
+        if (ec)
+            return {};
+        source.time = std::filesystem::last_write_time(data_file_name, ec).time_since_epoch().count();
+        if (ec)
+            return {};
+#ifndef _WIN32
+        struct stat info;
+        if (::stat(data_file_name.c_str(), &info) != 0)
+            return {};
+        source.inode = static_cast<std::uint64_t>(info.st_ino);
+#endif
+        return source;
+    }
+
+    const ZoneMapSource& source() const
+    {
+        return source_;
+    }
+
+    // true if the file is still the indexed one - an index without a known source matches no file
+    bool matches(const std::string& data_file_name) const
+    {
+        return source_ != ZoneMapSource{} && source_of(data_file_name) == source_;
+    }
+
+    // data must be the indexed data
+    ZoneSummary query(std::span<const double> data, std::size_t begin, std::size_t end) const
+    {
+        if (data.size() != count_)
+            throw std::invalid_argument("Zone map does not match data!!!");
+
+        return query(begin, end, [data](std::size_t first, std::size_t count) { return data.subspan(first, count); });
+    }
+
+    // file must be the indexed float64 file - only values of the partial edge blocks are read from it
+    ZoneSummary query(const BinaryFormat::BinaryFile& file, std::size_t begin, std::size_t end) const
+    {
+        if (file.header().element_type != BinaryFormat::ElementType::float64 || file.header().count != count_)
+            throw std::invalid_argument("Zone map does not match data!!!");
+
+        std::vector<double> edge;
+        return query(begin, end, [&](std::size_t first, std::size_t count) {
+            edge.resize(count);
+            std::memcpy(edge.data(), file.values() + first * sizeof(double), count * sizeof(double));
+            return std::span<const double>{edge};
+        });
+    }
+
+    // read_values(first, count) returns std::span<const double> of indexed values [first, first + count)
+    template <typename ReadValues>
+    ZoneSummary query(std::size_t begin, std::size_t end, ReadValues read_values) const
+    {
+        if (begin > end || end > count_)
+            throw std::out_of_range("Invalid range!!!");
+
+        ZoneSummary summary;
+        const std::size_t first_block = (begin + block_size_ - 1) / block_size_;
+        const std::size_t last_block = end / block_size_; // one past the last complete block
+
+        if (first_block >= last_block)
+        {
+            summary.add(read_values(begin, end - begin));
+            return summary;
+        }
+
+        summary.add(read_values(begin, first_block * block_size_ - begin));
+        for (std::size_t b = first_block; b < last_block; ++b)
+            summary.merge(blocks_[b]);
+        summary.add(read_values(last_block * block_size_, end - last_block * block_size_));
+
+        return summary;
+    }
+
+    // conventional name of sidecar index of data file
+    static std::string sidecar_name(const std::string& data_file_name)
+    {
+        return data_file_name + ".zonemap";
+    }
+
+    void save(const std::string& file_name) const
+    {
+        std::ofstream out{file_name, std::ios::binary};
+        if (!out)
+            throw std::runtime_error("File not opened!!!");
+
+        const std::uint64_t block_count = blocks_.size();
+        out.write(magic, sizeof(magic));
+        out.write(reinterpret_cast<const char*>(&version), sizeof(version));
+        out.write(reinterpret_cast<const char*>(&block_size_), sizeof(block_size_));
+        out.write(reinterpret_cast<const char*>(&count_), sizeof(count_));
+        out.write(reinterpret_cast<const char*>(&block_count), sizeof(block_count));
+        out.write(reinterpret_cast<const char*>(&source_), sizeof(source_));
+        out.write(reinterpret_cast<const char*>(blocks_.data()), blocks_.size() * sizeof(ZoneSummary));
+
+        if (!out)
+            throw std::runtime_error("File not written!!!");
+    }
+
+    static ZoneMap load(const std::string& file_name)
+    {
+        std::ifstream in{file_name, std::ios::binary};
+        if (!in)
+            throw std::runtime_error("File not opened!!!");
+
+        char file_magic[sizeof(magic)] = {};
+        std::uint32_t file_version = 0;
+        std::uint32_t block_size = 0;
+        std::uint64_t count = 0;
+        std::uint64_t block_count = 0;
+        ZoneMapSource source;
+        in.read(file_magic, sizeof(file_magic));
+        in.read(reinterpret_cast<char*>(&file_version), sizeof(file_version));
+        in.read(reinterpret_cast<char*>(&block_size), sizeof(block_size));
+        in.read(reinterpret_cast<char*>(&count), sizeof(count));
+        in.read(reinterpret_cast<char*>(&block_count), sizeof(block_count));
+        in.read(reinterpret_cast<char*>(&source), sizeof(source));
+
+        if (!in || std::memcmp(file_magic, magic, sizeof(magic)) != 0 || file_version != version || block_size == 0
+            || block_count != count / block_size + (count % block_size != 0))
+            throw std::runtime_error("Invalid zone map file!!!");
+
+        // block count is bounded by the file size before anything is allocated, so a crafted header cannot wrap it
+        const auto summaries_begin = in.tellg();
+        in.seekg(0, std::ios::end);
+        const auto summaries_size = static_cast<std::uint64_t>(in.tellg() - summaries_begin);
+        in.seekg(summaries_begin);
+        if (!in || block_count != summaries_size / sizeof(ZoneSummary) || summaries_size % sizeof(ZoneSummary) != 0)
+            throw std::runtime_error("Invalid zone map file!!!");
+
+        ZoneMap zone_map{block_size, count};
+        zone_map.source_ = source;
+        zone_map.blocks_.resize(block_count);
+        in.read(reinterpret_cast<char*>(zone_map.blocks_.data()), block_count * sizeof(ZoneSummary));
+
+        if (!in || in.peek() != std::ifstream::traits_type::eof())
+            throw std::runtime_error("Invalid zone map file!!!");
+
+        return zone_map;
+    }
+};
+
+#endif // ZONE_MAP_HPP
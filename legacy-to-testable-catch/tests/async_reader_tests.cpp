@@ -0,0 +1,179 @@
+#include <async_reader.hpp>
+#include <catch2/benchmark/catch_benchmark.hpp>
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/generators/catch_generators.hpp>
+#include <fstream>
+#include <iterator>
+#include <random>
+#include <streaming_data_analyzer.hpp>
+
+#ifdef __linux__
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+using namespace std;
+
+namespace
+{
+    std::vector<AsyncFileReader::Backend> available_backends()
+    {
+        std::vector<AsyncFileReader::Backend> backends{AsyncFileReader::Backend::threads};
+        try
+        {
+            AsyncFileReader reader{"data.dat", 1, 1, AsyncFileReader::Backend::io_uring};
+            backends.push_back(AsyncFileReader::Backend::io_uring);
+        }
+        catch (const std::system_error&)
+        {
+        }
+        return backends;
+    }
+
+    std::string file_content(const std::string& file_name)
+    {
+        std::ifstream in{file_name, std::ios::binary};
+        return {std::istreambuf_iterator<char>{in}, std::istreambuf_iterator<char>{}};
+    }
+
+    // evicts file from page cache, so the next read goes to the disk
+    void drop_from_page_cache([[maybe_unused]] const std::string& file_name)
+    {
+#ifdef __linux__
+        int fd = ::open(file_name.c_str(), O_RDONLY);
+        if (fd >= 0)
+        {
+            ::posix_fadvise(fd, 0, 0, POSIX_FADV_DONTNEED);
+            ::close(fd);
+        }
+#endif
+    }
+}
+
+TEST_CASE("AsyncFileReader - blocks contain the whole file in order")
+{
+    auto backend = GENERATE(from_range(available_backends()));
+    auto buffer_count = GENERATE(values<std::size_t>({1, 2, 4}));
+    auto buffer_size = GENERATE(values<std::size_t>({1, 7, 4096}));
+
+    AsyncFileReader reader{"data.dat", buffer_count, buffer_size, backend};
+    REQUIRE(reader.backend() == backend);
+
+    std::string content;
+    for (std::string_view block = reader.next(); !block.empty(); block = reader.next())
+    {
+        REQUIRE(block.size() <= buffer_size);
+        content.append(block);
+    }
+
+    REQUIRE(content == file_content("data.dat"));
+    REQUIRE(reader.next().empty());
+}
+
+TEST_CASE("AsyncFileReader - special files")
+{
+    auto backend = GENERATE(from_range(available_backends()));
+
+    SECTION("empty file")
+    {
+        std::ofstream{"async_empty.dat"};
+
+        AsyncFileReader reader{"async_empty.dat", 4, 16, backend};
+        REQUIRE(reader.next().empty());
+    }
+
+    SECTION("missing file")
+    {
+        REQUIRE_THROWS_AS(AsyncFileReader("async_missing.dat", 4, 16, backend), std::runtime_error);
+    }
+
+    SECTION("reader destroyed with reads in flight")
+    {
+        AsyncFileReader reader{"data.dat", 8, 16, backend};
+        REQUIRE(!reader.next().empty());
+    }
+}
+
+TEST_CASE("AsyncStreamReader - chunks contain the same data as text_reader")
+{
+    auto backend = GENERATE(from_range(available_backends()));
+    auto buffer_size = GENERATE(values<std::size_t>({1, 7, 4096}));
+    auto chunk_size = GENERATE(values<std::size_t>({3, 1000}));
+
+    AsyncStreamReader reader{chunk_size, 3, buffer_size, backend};
+
+    Data data;
+    reader("data.dat", [&](std::span<const double> chunk) {
+        REQUIRE(chunk.size() > 0);
+        REQUIRE(chunk.size() <= chunk_size);
+        data.insert(data.end(), chunk.begin(), chunk.end());
+    });
+
+    REQUIRE(data == Ver_2::text_reader("data.dat"));
+}
+
+TEST_CASE("async readers - plug into analyzers")
+{
+    SECTION("DataAnalyzer")
+    {
+        Ver_2::DataAnalyzer data_analyzer(Ver_2::Statistics::sum, async_text_reader);
+        data_analyzer.load_data("data.dat");
+        data_analyzer.calculate();
+
+        REQUIRE(data_analyzer.results() == Results{{"Sum", 4715.0}});
+    }
+
+    SECTION("StreamingDataAnalyzer")
+    {
+        Ver_2::StreamingDataAnalyzer data_analyzer(Ver_2::Statistics::sum, async_stream_reader);
+        data_analyzer.calculate("data.dat");
+
+        REQUIRE(data_analyzer.results() == Results{{"Sum", 4715.0}});
+    }
+}
+
+TEST_CASE("async readers - benchmark", "[.][benchmark]")
+{
+    {
+        std::mt19937_64 rnd_gen{42};
+        std::uniform_real_distribution<double> distr{-1000.0, 1000.0};
+        std::ofstream out{"async_benchmark.dat"};
+        for (int i = 0; i < 4'000'000; ++i)
+            out << distr(rnd_gen) << "\n";
+    }
+
+    // every run reads the file from the disk
+    auto sum_of_file = [](const DataStreamReader& reader) {
+        drop_from_page_cache("async_benchmark.dat");
+        auto accumulator = Ver_2::Statistics::sum->make_accumulator();
+        reader("async_benchmark.dat", [&](std::span<const double> values) { accumulator->update(values); });
+        return accumulator->finalize();
+    };
+
+    BENCHMARK("TextStreamReader - cold cache")
+    {
+        return sum_of_file(TextStreamReader{});
+    };
+
+    BENCHMARK("AsyncStreamReader - threads, cold cache")
+    {
+        return sum_of_file(AsyncStreamReader{TextStreamReader::default_chunk_size, 4, AsyncFileReader::default_buffer_size, AsyncFileReader::Backend::threads});
+    };
+
+    BENCHMARK("AsyncStreamReader - io_uring if available, cold cache")
+    {
+        return sum_of_file(AsyncStreamReader{});
+    };
+
+    BENCHMARK("DataAnalyzer::load_data - mmap_reader, cold cache")
+    {
+        drop_from_page_cache("async_benchmark.dat");
+        return mmap_reader("async_benchmark.dat");
+    };
+
+    BENCHMARK("DataAnalyzer::load_data - async_text_reader, cold cache")
+    {
+        drop_from_page_cache("async_benchmark.dat");
+        return async_text_reader("async_benchmark.dat");
+    };
+}
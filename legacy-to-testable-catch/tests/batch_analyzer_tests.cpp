@@ -0,0 +1,108 @@
+#include <batch_analyzer.hpp>
+#include <catch2/benchmark/catch_benchmark.hpp>
+#include <catch2/catch_test_macros.hpp>
+#include <filesystem>
+#include <fstream>
+
+using namespace std;
+
+namespace
+{
+    void create_data_files(const std::string& directory, std::size_t count)
+    {
+        std::filesystem::remove_all(directory);
+        std::filesystem::create_directories(directory);
+        for (std::size_t i = 0; i < count; ++i)
+        {
+            std::ofstream out{directory + "/data_" + std::to_string(1000 + i) + ".dat"};
+            for (std::size_t j = 0; j <= i % 10; ++j)
+                out << j << "\n";
+        }
+    }
+
+    std::vector<std::string> read_lines(const std::string& file_name)
+    {
+        std::ifstream fin{file_name};
+        std::vector<std::string> lines;
+        for (std::string line; std::getline(fin, line);)
+            lines.push_back(line);
+        return lines;
+    }
+}
+
+TEST_CASE("matches_wildcard")
+{
+    REQUIRE(matches_wildcard("*.dat", "data.dat"));
+    REQUIRE(matches_wildcard("data_??.dat", "data_12.dat"));
+    REQUIRE(matches_wildcard("*", ""));
+    REQUIRE(matches_wildcard("a*b*c", "aXXbYc"));
+    REQUIRE_FALSE(matches_wildcard("*.dat", "data.txt"));
+    REQUIRE_FALSE(matches_wildcard("data_?.dat", "data_12.dat"));
+}
+
+TEST_CASE("list_files - directory or glob")
+{
+    create_data_files("batch_list", 3);
+    std::ofstream{"batch_list/notes.txt"} << "notes";
+
+    REQUIRE(list_files("batch_list").size() == 4);
+    REQUIRE(list_files("batch_list/*.dat")
+        == std::vector<std::string>{"batch_list/data_1000.dat", "batch_list/data_1001.dat", "batch_list/data_1002.dat"});
+    REQUIRE_THROWS_AS(list_files("no_such_directory/*.dat"), std::runtime_error);
+}
+
+TEST_CASE("BatchAnalyzer - consolidated results in order of files", "[Integration]")
+{
+    create_data_files("batch", 100);
+    std::ofstream{"batch/data_9999.dat"} << "1 2 x";
+    std::filesystem::create_directory("batch/data_zzz.dat");
+
+    for (std::uint64_t batch_bytes : {std::uint64_t{1}, Ver_2::BatchAnalyzer::default_batch_bytes})
+    {
+        Ver_2::BatchAnalyzer analyzer{{Ver_2::Statistics::sum, Ver_2::Statistics::min_max}, mmap_reader, 4, batch_bytes};
+        BatchReport report = analyzer.run("batch/*.dat", "batch_results.txt");
+
+        REQUIRE(report.file_count == 101);
+        REQUIRE(report.failed_count == 0);
+        REQUIRE(report.bytes > 0);
+        REQUIRE(report.files_per_second() > 0);
+
+        auto lines = read_lines("batch_results.txt");
+        REQUIRE(lines.size() == 303);
+        REQUIRE(lines[0] == "batch/data_1000.dat: Sum = 0");
+        REQUIRE(lines[3] == "batch/data_1001.dat: Sum = 1");
+        REQUIRE(lines[27] == "batch/data_1009.dat: Sum = 45");
+        REQUIRE(lines[29] == "batch/data_1009.dat: Max = 9");
+        REQUIRE(lines[300] == "batch/data_9999.dat: Sum = 3");
+    }
+
+    SECTION("failed files are reported")
+    {
+        Ver_2::BatchAnalyzer analyzer{{Ver_2::Statistics::sum}};
+        BatchReport report = analyzer.run(std::vector<std::string>{"batch/data_1001.dat", "batch/missing.dat"}, "batch_results.txt");
+
+        REQUIRE(report.failed_count == 1);
+        REQUIRE(read_lines("batch_results.txt") == std::vector<std::string>{"batch/data_1001.dat: Sum = 1", "batch/missing.dat: error: File not opened!!!"});
+    }
+}
+
+TEST_CASE("BatchAnalyzer - benchmark", "[.][benchmark]")
+{
+    create_data_files("batch_benchmark", 10'000);
+    auto files = list_files("batch_benchmark");
+
+    BENCHMARK("one DataAnalyzer at a time")
+    {
+        for (const auto& file : files)
+        {
+            Ver_2::DataAnalyzer analyzer{Ver_2::Statistics::sum};
+            analyzer.load_data(file);
+            analyzer.calculate();
+        }
+    };
+
+    BENCHMARK("BatchAnalyzer")
+    {
+        return Ver_2::BatchAnalyzer{{Ver_2::Statistics::sum}}.run(files, "batch_benchmark_results.txt");
+    };
+}
@@ -0,0 +1,120 @@
+#include <binary_format.hpp>
+#include <catch2/benchmark/catch_benchmark.hpp>
+#include <catch2/catch_test_macros.hpp>
+#include <cmath>
+#include <cstring>
+#include <limits>
+#include <mmap_reader.hpp>
+#include <numeric>
+#include <random>
+
+using namespace std;
+
+TEST_CASE("binary format - round trip")
+{
+    SECTION("text data")
+    {
+        Data data = Ver_1::text_reader("data.dat");
+        binary_writer("binary_round_trip.bin", data);
+
+        REQUIRE(BinaryFormat::is_binary_file("binary_round_trip.bin"));
+        REQUIRE(binary_reader("binary_round_trip.bin") == data);
+    }
+
+    SECTION("many blocks and special values")
+    {
+        Data data(BinaryFormat::default_block_size * 2 + 7);
+        std::iota(data.begin(), data.end(), -100.5);
+        data.back() = std::numeric_limits<double>::infinity();
+        data.front() = -0.0;
+
+        binary_writer("binary_blocks.bin", data);
+
+        Data loaded = binary_reader("binary_blocks.bin");
+        REQUIRE(loaded == data);
+        REQUIRE(std::signbit(loaded.front()));
+    }
+
+    SECTION("empty data")
+    {
+        binary_writer("binary_empty.bin", Data{});
+
+        REQUIRE(binary_reader("binary_empty.bin").empty());
+    }
+}
+
+TEST_CASE("binary format - invalid files")
+{
+    SECTION("text file is rejected")
+    {
+        REQUIRE_FALSE(BinaryFormat::is_binary_file("data.dat"));
+        REQUIRE_THROWS_AS(binary_reader("data.dat"), std::runtime_error);
+    }
+
+    SECTION("corrupted value is detected")
+    {
+        binary_writer("binary_corrupted.bin", Data{1.0, 2.0, 3.0});
+        {
+            std::fstream file{"binary_corrupted.bin", std::ios::in | std::ios::out | std::ios::binary};
+            file.seekp(-1, std::ios::end);
+            file.put('\x7f');
+        }
+
+        REQUIRE_THROWS_AS(binary_reader("binary_corrupted.bin"), std::runtime_error);
+    }
+
+    SECTION("sizes that wrap around in a crafted header are rejected")
+    {
+        BinaryFormat::BinaryHeader header{};
+        std::memcpy(header.magic, BinaryFormat::magic, sizeof(header.magic));
+        header.version = BinaryFormat::version;
+        header.element_type = BinaryFormat::ElementType::float64;
+        header.element_size = sizeof(double);
+        header.block_size = 1;
+        header.count = (std::uint64_t{1} << 61) + 1; // count * 8 and block_count * 8 wrap to 8
+        header.block_count = header.count;
+        {
+            std::ofstream out{"binary_wrapped.bin", std::ios::binary};
+            out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+            out.write(std::string(16, '\0').data(), 16);
+        }
+
+        REQUIRE_THROWS_AS(binary_reader("binary_wrapped.bin"), std::runtime_error);
+    }
+}
+
+TEST_CASE("binary_reader - plugs into DataAnalyzer")
+{
+    binary_writer("data.bin", Ver_1::text_reader("data.dat"));
+
+    Ver_2::DataAnalyzer data_analyzer(Ver_2::Statistics::sum, binary_reader);
+    data_analyzer.load_data("data.bin");
+    data_analyzer.calculate();
+
+    REQUIRE(data_analyzer.results() == Results{{"Sum", 4715.0}});
+}
+
+TEST_CASE("binary_reader - benchmark", "[.][benchmark]")
+{
+    Data data(4'000'000);
+    std::mt19937_64 rnd_gen{42};
+    std::uniform_real_distribution<double> distr{-1000.0, 1000.0};
+    std::generate(data.begin(), data.end(), [&] { return distr(rnd_gen); });
+
+    {
+        std::ofstream out{"binary_benchmark.dat"};
+        for (double d : data)
+            out << d << "\n";
+    }
+    binary_writer("binary_benchmark.bin", data);
+
+    BENCHMARK("mmap_reader - text")
+    {
+        return mmap_reader("binary_benchmark.dat");
+    };
+
+    BENCHMARK("binary_reader")
+    {
+        return binary_reader("binary_benchmark.bin");
+    };
+}
@@ -0,0 +1,239 @@
+#include <binary_format.hpp>
+#include <catch2/benchmark/catch_benchmark.hpp>
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/generators/catch_generators.hpp>
+#include <cmath>
+#include <compressed_format.hpp>
+#include <cstring>
+#include <filesystem>
+#include <limits>
+#include <numeric>
+#include <random>
+#include <streaming_data_analyzer.hpp>
+#include "test_data.hpp"
+
+using namespace std;
+
+namespace
+{
+    // compares bits, so NaNs and -0.0 are checked too
+    bool same_bits(const Data& a, const Data& b)
+    {
+        return a.size() == b.size() && std::memcmp(a.data(), b.data(), a.size() * sizeof(double)) == 0;
+    }
+
+    Data random_values(std::size_t size)
+    {
+        return make_random_data(size, std::uniform_real_distribution<double>{-1000.0, 1000.0}, 42);
+    }
+
+    // slowly changing sensor readings with 2 decimal places
+    Data sensor_values(std::size_t size)
+    {
+        Data data(size);
+        std::mt19937_64 rnd_gen{42};
+        std::uniform_int_distribution<int> step{-3, 3};
+        int value = 2000;
+        std::generate(data.begin(), data.end(), [&] {
+            value += step(rnd_gen);
+            return value / 100.0;
+        });
+        return data;
+    }
+
+    // counters - integer values growing by small steps
+    Data counter_values(std::size_t size)
+    {
+        Data data(size);
+        std::mt19937_64 rnd_gen{42};
+        std::uniform_int_distribution<int> step{0, 100};
+        double value = 1e12;
+        std::generate(data.begin(), data.end(), [&] { return value += step(rnd_gen); });
+        return data;
+    }
+}
+
+TEST_CASE("compressed format - round trip")
+{
+    auto check_round_trip = [](const Data& data) {
+        compressed_writer("compressed_round_trip.tdcz", data);
+
+        REQUIRE(CompressedFormat::is_compressed_file("compressed_round_trip.tdcz"));
+        REQUIRE(same_bits(compressed_reader("compressed_round_trip.tdcz"), data));
+    };
+
+    SECTION("text data")
+    {
+        check_round_trip(Ver_1::text_reader("data.dat"));
+    }
+
+    SECTION("empty data")
+    {
+        check_round_trip(Data{});
+    }
+
+    SECTION("integers, floats and random values in many blocks")
+    {
+        const std::size_t size = CompressedFormat::default_block_size * 3 + 17;
+
+        check_round_trip(counter_values(size));
+        check_round_trip(sensor_values(size));
+        check_round_trip(random_values(size));
+        check_round_trip(Data(size, 7.0));
+    }
+
+    SECTION("special values")
+    {
+        const double limit = 9007199254740992.0; // 2^53
+        check_round_trip(Data{limit, -limit, 0.0, limit, -limit});
+        check_round_trip(Data{-0.0, 0.0, 1.0, -0.0});
+        check_round_trip(Data{limit * 2, 1.0, 2.0});
+        check_round_trip(Data{std::numeric_limits<double>::quiet_NaN(), std::numeric_limits<double>::infinity(), -std::numeric_limits<double>::infinity(),
+            std::numeric_limits<double>::denorm_min(), std::numeric_limits<double>::max(), std::numeric_limits<double>::lowest(), 0.1});
+    }
+}
+
+TEST_CASE("compressed format - compression ratio")
+{
+    const std::size_t size = 100'000;
+    const auto raw_size = size * sizeof(double);
+
+    SECTION("counters are bit-packed deltas")
+    {
+        compressed_writer("counters.tdcz", counter_values(size));
+
+        REQUIRE(std::filesystem::file_size("counters.tdcz") < raw_size / 6);
+    }
+
+    SECTION("slowly changing floats")
+    {
+        compressed_writer("sensor.tdcz", sensor_values(size));
+
+        REQUIRE(std::filesystem::file_size("sensor.tdcz") < raw_size);
+    }
+
+    SECTION("random values are stored raw rather than expanded")
+    {
+        compressed_writer("random.tdcz", random_values(size));
+
+        REQUIRE(std::filesystem::file_size("random.tdcz") < raw_size + raw_size / 100);
+    }
+}
+
+TEST_CASE("CompressedWriter - values can be written in chunks of any size")
+{
+    const Data data = sensor_values(50'000);
+    compressed_writer("compressed_whole.tdcz", data);
+
+    auto chunk_size = GENERATE(values<std::size_t>({1, 1000, 8192, 30'000}));
+    {
+        CompressedWriter writer{"compressed_chunks.tdcz"};
+        std::span<const double> values{data};
+        for (std::size_t offset = 0; offset < values.size(); offset += chunk_size)
+            writer.write(values.subspan(offset, std::min(chunk_size, values.size() - offset)));
+    } // closed by destructor
+
+    REQUIRE(compressed_reader("compressed_chunks.tdcz") == data);
+    REQUIRE(std::filesystem::file_size("compressed_chunks.tdcz") == std::filesystem::file_size("compressed_whole.tdcz"));
+}
+
+TEST_CASE("compressed_stream_reader - blocks are passed to statistics")
+{
+    Data data(CompressedFormat::default_block_size * 2 + 5);
+    std::iota(data.begin(), data.end(), -100.0);
+    compressed_writer("compressed_stream.tdcz", data);
+
+    SECTION("chunks are decoded blocks")
+    {
+        Data read;
+        compressed_stream_reader("compressed_stream.tdcz", [&](std::span<const double> chunk) {
+            REQUIRE(chunk.size() > 0);
+            REQUIRE(chunk.size() <= CompressedFormat::default_block_size);
+            read.insert(read.end(), chunk.begin(), chunk.end());
+        });
+
+        REQUIRE(read == data);
+    }
+
+    SECTION("plugs into StreamingDataAnalyzer")
+    {
+        Ver_2::StreamingDataAnalyzer data_analyzer(Ver_2::Statistics::sum, compressed_stream_reader);
+        data_analyzer.calculate("compressed_stream.tdcz");
+
+        REQUIRE(data_analyzer.results() == Ver_2::Statistics::sum->calculate(data));
+    }
+}
+
+TEST_CASE("compressed format - invalid files")
+{
+    SECTION("text file is rejected")
+    {
+        REQUIRE_FALSE(CompressedFormat::is_compressed_file("data.dat"));
+        REQUIRE_THROWS_AS(compressed_reader("data.dat"), std::runtime_error);
+    }
+
+    auto file = GENERATE(values<std::string>({"counters", "sensor", "random"}));
+    {
+        CompressedWriter writer{"compressed_damaged.tdcz"};
+        writer.write(file == "counters" ? counter_values(1000) : file == "sensor" ? sensor_values(1000) : random_values(1000));
+    }
+    const auto size = std::filesystem::file_size("compressed_damaged.tdcz");
+
+    SECTION("corrupted payload is detected")
+    {
+        {
+            std::fstream out{"compressed_damaged.tdcz", std::ios::in | std::ios::out | std::ios::binary};
+            out.seekp(sizeof(CompressedFormat::FileHeader) + sizeof(CompressedFormat::BlockHeader) + 3);
+            out.put('\x55');
+        }
+
+        REQUIRE_THROWS_AS(compressed_reader("compressed_damaged.tdcz"), std::runtime_error);
+    }
+
+    SECTION("truncated file is detected")
+    {
+        std::filesystem::resize_file("compressed_damaged.tdcz", size - 1);
+
+        REQUIRE_THROWS_AS(compressed_reader("compressed_damaged.tdcz"), std::runtime_error);
+    }
+}
+
+TEST_CASE("compressed format - benchmark", "[.][benchmark]")
+{
+    const std::size_t size = 8'000'000;
+    const Data counters = counter_values(size);
+    const Data sensor = sensor_values(size);
+
+    binary_writer("benchmark_raw.bin", counters);
+    compressed_writer("benchmark_counters.tdcz", counters);
+    compressed_writer("benchmark_sensor.tdcz", sensor);
+
+    BENCHMARK("binary_reader - raw")
+    {
+        return binary_reader("benchmark_raw.bin");
+    };
+
+    BENCHMARK("compressed_reader - counters")
+    {
+        return compressed_reader("benchmark_counters.tdcz");
+    };
+
+    BENCHMARK("compressed_reader - sensor floats")
+    {
+        return compressed_reader("benchmark_sensor.tdcz");
+    };
+
+    BENCHMARK("compressed_stream_reader - sum of counters")
+    {
+        auto accumulator = Ver_2::Statistics::sum->make_accumulator();
+        compressed_stream_reader("benchmark_counters.tdcz", [&](std::span<const double> values) { accumulator->update(values); });
+        return accumulator->finalize();
+    };
+
+    BENCHMARK("compressed_stream_reader - sum of sensor floats")
+    {
+        auto accumulator = Ver_2::Statistics::sum->make_accumulator();
+        compressed_stream_reader("benchmark_sensor.tdcz", [&](std::span<const double> values) { accumulator->update(values); });
+        return accumulator->finalize();
+    };
+}
@@ -1,9 +1,17 @@
+#include <catch2/benchmark/catch_benchmark.hpp>
 #include <catch2/catch_test_macros.hpp>
 #include <data_analyzer.hpp>
+#include <random>
 #include <sstream>
+#include "test_data.hpp"
 
 using namespace std;
 
+namespace
+{
+    const std::uniform_real_distribution<double> data_distr{-1000.0, 1000.0};
+}
+
 std::string get_file_contents(const std::string& file_name)
 {
     std::ifstream in{file_name};
@@ -43,6 +51,7 @@ TEST_CASE("DataAnalyzer - test reading")
     };
 
     Ver_1::DataAnalyzer data_analyzer(Statistics::sum, testable_reader);
+    data_analyzer.load_data("data.dat");
     data_analyzer.calculate();
 
     REQUIRE(data_analyzer.results() == Results{{"Sum", 15.0}});
@@ -54,4 +63,57 @@ TEST_CASE("Avg")
 
     Ver_2::Avg avg;
     REQUIRE(avg.calculate(data) == Results{{"Avg", 3.0}});
-}
\ No newline at end of file
+}
+
+TEST_CASE("Ver_2::DataAnalyzer - fused statistics give the same results as separate calls")
+{
+    auto random_reader = [](const std::string&) { return make_random_data(100'003, data_distr); };
+
+    Ver_2::DataAnalyzer separate(Ver_2::Statistics::avg, random_reader);
+    separate.load_data("random");
+    separate.calculate();
+    separate.set_statistics(Ver_2::Statistics::min_max);
+    separate.calculate();
+    separate.set_statistics(Ver_2::Statistics::sum);
+    separate.calculate();
+
+    Ver_2::DataAnalyzer fused(Ver_2::Statistics::avg, random_reader);
+    fused.load_data("random");
+    fused.set_statistics({Ver_2::Statistics::avg, Ver_2::Statistics::min_max, Ver_2::Statistics::sum});
+    fused.calculate();
+
+    REQUIRE(fused.results() == separate.results());
+}
+
+TEST_CASE("Ver_2::DataAnalyzer - fused statistics", "[Integration]")
+{
+    Ver_2::DataAnalyzer data_analyzer(Ver_2::Statistics::avg);
+    data_analyzer.load_data("data.dat");
+    data_analyzer.set_statistics({Ver_2::Statistics::avg, Ver_2::Statistics::min_max, Ver_2::Statistics::sum});
+    data_analyzer.calculate();
+
+    REQUIRE(data_analyzer.results() == Results{{"Avg", 47.15}, {"Min", 1.0}, {"Max", 99.0}, {"Sum", 4715.0}});
+}
+
+TEST_CASE("Ver_2::DataAnalyzer - fused statistics benchmark", "[.][benchmark]")
+{
+    Data data = make_random_data(32'000'000, data_distr);
+
+    std::vector<std::shared_ptr<Ver_2::IStatistics>> stats = {Ver_2::Statistics::avg, Ver_2::Statistics::min_max, Ver_2::Statistics::sum};
+
+    BENCHMARK("separate passes")
+    {
+        Results results;
+        for (const auto& stat : stats)
+        {
+            Results current_results = stat->calculate(data);
+            results.insert(results.end(), current_results.begin(), current_results.end());
+        }
+        return results;
+    };
+
+    BENCHMARK("fused pass")
+    {
+        return Ver_2::calculate_fused(stats, data);
+    };
+}
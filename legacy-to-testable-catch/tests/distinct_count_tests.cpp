@@ -0,0 +1,117 @@
+#include <catch2/benchmark/catch_benchmark.hpp>
+#include <catch2/catch_test_macros.hpp>
+#include <cmath>
+#include <distinct_count.hpp>
+#include <random>
+
+using namespace std;
+
+namespace
+{
+    // values 0..distinct-1 in random order, each repeated
+    Data make_repeated_data(std::size_t distinct, std::size_t repeats)
+    {
+        Data data;
+        data.reserve(distinct * repeats);
+        for (std::size_t r = 0; r < repeats; ++r)
+            for (std::size_t i = 0; i < distinct; ++i)
+                data.push_back(static_cast<double>(i));
+        std::shuffle(data.begin(), data.end(), std::mt19937_64{distinct});
+        return data;
+    }
+
+    double relative_error(const Results& results, std::size_t expected)
+    {
+        REQUIRE(results.size() == 1);
+        REQUIRE(results[0].description == "DistinctCount");
+        return std::abs(results[0].value - expected) / expected;
+    }
+}
+
+TEST_CASE("DistinctCount - small input is exact")
+{
+    Data data = {1.0, 2.0, 1.0, 0.0, -0.0, std::nan(""), 3.5, 2.0};
+
+    REQUIRE(Ver_2::Statistics::distinct_count->calculate(data) == Results{{"DistinctCount", 4.0}});
+    REQUIRE(Ver_2::Statistics::distinct_count->calculate(Data{}) == Results{{"DistinctCount", 0.0}});
+
+    Data repeated = make_repeated_data(200, 50);
+    REQUIRE(Ver_2::Statistics::distinct_count->calculate(repeated) == Results{{"DistinctCount", 200.0}});
+}
+
+TEST_CASE("DistinctCount - estimate is within a few standard errors")
+{
+    for (std::size_t distinct : {1'000, 50'000, 1'000'000})
+    {
+        INFO("distinct: " << distinct);
+        Data data = make_repeated_data(distinct, 2);
+
+        REQUIRE(relative_error(Ver_2::Statistics::distinct_count->calculate(data), distinct) < 0.05);
+    }
+}
+
+TEST_CASE("DistinctCount - memory is bounded")
+{
+    HyperLogLog sketch;
+    REQUIRE(sketch.is_exact());
+
+    Data data = make_repeated_data(100'000, 1);
+    sketch.update(data);
+
+    REQUIRE_FALSE(sketch.is_exact());
+
+    StateWriter state{"HyperLogLog"};
+    sketch.serialize(state);
+    REQUIRE(state.str().size() < 5 * 1024);
+}
+
+TEST_CASE("DistinctCount - parallel and sharded results are the same as fused")
+{
+    Data data = make_repeated_data(100'000, 2);
+    auto expected = Ver_2::calculate_fused({Ver_2::Statistics::distinct_count}, data);
+
+    SECTION("parallel")
+    {
+        REQUIRE(Ver_2::calculate_parallel({Ver_2::Statistics::distinct_count}, data, 4) == expected);
+    }
+
+    SECTION("serialized shards - exact and estimated")
+    {
+        std::vector<std::string> states;
+        for (std::size_t offset = 0; offset < data.size(); offset += 50'000)
+        {
+            auto shard = Ver_2::Statistics::distinct_count->make_accumulator();
+            shard->update(std::span<const double>{data}.subspan(offset, 50'000));
+            states.push_back(shard->serialize());
+        }
+
+        auto small_shard = Ver_2::Statistics::distinct_count->make_accumulator();
+        small_shard->update(std::span<const double>{data}.first(10));
+        states.push_back(small_shard->serialize());
+
+        REQUIRE(Ver_2::merge_states(*Ver_2::Statistics::distinct_count, states) == expected);
+    }
+
+    SECTION("precision must match")
+    {
+        auto accumulator = Ver_2::Statistics::distinct_count->make_accumulator();
+        auto other = Ver_2::DistinctCount{10}.make_accumulator();
+
+        REQUIRE_THROWS_AS(accumulator->merge(*other), std::invalid_argument);
+    }
+}
+
+TEST_CASE("DistinctCount - benchmark", "[.][benchmark]")
+{
+    Data data = make_repeated_data(10'000'000, 4);
+
+    BENCHMARK("Sum")
+    {
+        return Ver_2::calculate_fused({Ver_2::Statistics::sum}, data);
+    };
+
+    BENCHMARK("DistinctCount")
+    {
+        return Ver_2::calculate_fused({Ver_2::Statistics::distinct_count}, data);
+    };
+}
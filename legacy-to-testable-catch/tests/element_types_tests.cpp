@@ -0,0 +1,162 @@
+#include <binary_format.hpp>
+#include <catch2/benchmark/catch_benchmark.hpp>
+#include <catch2/catch_test_macros.hpp>
+#include <cstdint>
+#include <data_analyzer.hpp>
+#include <limits>
+#include <mmap_reader.hpp>
+#include <numeric>
+#include <percentiles.hpp>
+#include <random>
+#include "test_data.hpp"
+
+using namespace std;
+
+namespace
+{
+    const std::uniform_real_distribution<double> data_distr{-1000.0, 1000.0};
+}
+
+TEST_CASE("element types - readers")
+{
+    const Data expected = Ver_1::text_reader("data.dat");
+
+    SECTION("text")
+    {
+        auto data = Ver_2::basic_text_reader<std::int32_t>("data.dat");
+
+        REQUIRE(data == BasicData<std::int32_t>(expected.begin(), expected.end()));
+    }
+
+    SECTION("memory mapped text")
+    {
+        REQUIRE(basic_mmap_reader<float>("data.dat") == BasicData<float>(expected.begin(), expected.end()));
+        REQUIRE(basic_mmap_reader<std::int64_t>("data.dat") == BasicData<std::int64_t>(expected.begin(), expected.end()));
+    }
+
+    SECTION("integers stop at a fraction")
+    {
+        BasicData<std::int32_t> data;
+        const std::string_view text = "1 -2 +3 4.5 6";
+
+        REQUIRE(parse_numbers(text, data) == text.find('.'));
+        REQUIRE(data == BasicData<std::int32_t>{1, -2, 3, 4});
+    }
+}
+
+TEST_CASE("element types - binary format")
+{
+    SECTION("round trip")
+    {
+        BasicData<std::int32_t> int32_data{std::numeric_limits<std::int32_t>::min(), -1, 0, std::numeric_limits<std::int32_t>::max()};
+        binary_writer("int32.bin", int32_data);
+        REQUIRE(basic_binary_reader<std::int32_t>("int32.bin") == int32_data);
+
+        BasicData<std::int64_t> int64_data{std::numeric_limits<std::int64_t>::min(), (std::int64_t{1} << 53) + 1};
+        binary_writer("int64.bin", int64_data);
+        REQUIRE(basic_binary_reader<std::int64_t>("int64.bin") == int64_data);
+
+        BasicData<float> float_data(BinaryFormat::default_block_size + 3);
+        std::iota(float_data.begin(), float_data.end(), -0.5f);
+        binary_writer("float.bin", float_data);
+        REQUIRE(basic_binary_reader<float>("float.bin") == float_data);
+    }
+
+    SECTION("element type must match")
+    {
+        binary_writer("float.bin", BasicData<float>{1.0f, 2.0f});
+
+        REQUIRE_THROWS_AS(binary_reader("float.bin"), std::runtime_error);
+        REQUIRE_THROWS_AS(basic_binary_reader<std::int32_t>("float.bin"), std::runtime_error);
+    }
+}
+
+TEST_CASE("element types - statistics")
+{
+    const std::vector<std::shared_ptr<Ver_2::IStatistics>> stats{Ver_2::Statistics::avg, Ver_2::Statistics::min_max, Ver_2::Statistics::sum};
+
+    SECTION("same results as double data")
+    {
+        const Data data = Ver_1::text_reader("data.dat");
+        const auto expected = Ver_2::calculate_fused(stats, data);
+
+        REQUIRE(Ver_2::calculate_fused(stats, BasicData<std::int32_t>(data.begin(), data.end())) == expected);
+        REQUIRE(Ver_2::calculate_fused(stats, BasicData<std::int64_t>(data.begin(), data.end())) == expected);
+        REQUIRE(Ver_2::calculate_fused(stats, BasicData<float>(data.begin(), data.end())) == expected);
+    }
+
+    SECTION("int32 sums do not overflow")
+    {
+        BasicData<std::int32_t> data(3, std::numeric_limits<std::int32_t>::max());
+
+        REQUIRE(Ver_2::calculate_fused({Ver_2::Statistics::sum}, data) == Results{{"Sum", 3.0 * std::numeric_limits<std::int32_t>::max()}});
+    }
+
+    SECTION("int64 sums are exact")
+    {
+        const std::int64_t large = std::int64_t{1} << 62;
+        BasicData<std::int64_t> data{large, 1, -large, large, -large};
+
+        REQUIRE(Ver_2::calculate_fused({Ver_2::Statistics::sum}, data) == Results{{"Sum", 1.0}});
+        REQUIRE(Ver_2::calculate_fused({Ver_2::Statistics::avg}, data) == Results{{"Avg", 0.2}});
+    }
+
+    SECTION("float values are accumulated in double")
+    {
+        BasicData<float> data(1'000'000, 0.1f);
+
+        auto results = Ver_2::calculate_fused({Ver_2::Statistics::sum}, data);
+
+        REQUIRE(results == Results{{"Sum", 1'000'000 * static_cast<double>(0.1f)}});
+    }
+
+    SECTION("parallel calculation merges integer states")
+    {
+        BasicData<std::int64_t> data(100'000);
+        std::iota(data.begin(), data.end(), std::int64_t{1} << 40);
+
+        REQUIRE(Ver_2::calculate_parallel(stats, data, 4) == Ver_2::calculate_fused(stats, data));
+    }
+
+    SECTION("statistics that are not incremental get converted data")
+    {
+        BasicData<float> data{3.0f, 1.0f, 2.0f};
+
+        auto results = Ver_2::calculate_fused({std::make_shared<Ver_2::Percentiles>(std::vector<double>{0.5})}, data);
+
+        REQUIRE(results.front().value == 2.0);
+    }
+}
+
+TEST_CASE("BasicDataAnalyzer - int32 data")
+{
+    Ver_2::BasicDataAnalyzer<std::int32_t> data_analyzer(Ver_2::Statistics::sum, basic_mmap_reader<std::int32_t>);
+    data_analyzer.load_data("data.dat");
+    data_analyzer.calculate();
+
+    REQUIRE(data_analyzer.results() == Results{{"Sum", 4715.0}});
+}
+
+TEST_CASE("element types - benchmark", "[.][benchmark]")
+{
+    const Data data = make_random_data(50'000'000, data_distr);
+
+    const BasicData<float> float_data(data.begin(), data.end());
+    const BasicData<std::int32_t> int32_data(data.begin(), data.end());
+    const std::vector<std::shared_ptr<Ver_2::IStatistics>> stats{Ver_2::Statistics::sum, Ver_2::Statistics::min_max};
+
+    BENCHMARK("double")
+    {
+        return Ver_2::calculate_fused(stats, data);
+    };
+
+    BENCHMARK("float")
+    {
+        return Ver_2::calculate_fused(stats, float_data);
+    };
+
+    BENCHMARK("int32")
+    {
+        return Ver_2::calculate_fused(stats, int32_data);
+    };
+}
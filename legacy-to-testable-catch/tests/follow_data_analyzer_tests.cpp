@@ -0,0 +1,121 @@
+#include <atomic>
+#include <catch2/catch_test_macros.hpp>
+#include <filesystem>
+#include <follow_data_analyzer.hpp>
+#include <fstream>
+#include <thread>
+
+using namespace std;
+
+namespace
+{
+    void append(const std::string& file_name, const std::string& text)
+    {
+        std::ofstream out{file_name, std::ios::app | std::ios::binary};
+        out << text;
+    }
+
+    void create(const std::string& file_name, const std::string& text = "")
+    {
+        std::ofstream out{file_name, std::ios::trunc | std::ios::binary};
+        out << text;
+    }
+}
+
+TEST_CASE("FollowDataAnalyzer - only appended data is parsed")
+{
+    create("follow.dat", "1 2\n3");
+    Ver_2::FollowDataAnalyzer data_analyzer{"follow.dat", {Ver_2::Statistics::sum, Ver_2::Statistics::min_max}};
+
+    REQUIRE(data_analyzer.refresh());
+    REQUIRE(data_analyzer.results() == Results{{"Sum", 3}, {"Min", 1}, {"Max", 2}});
+    REQUIRE(data_analyzer.offset() == 4);
+
+    SECTION("partial trailing number is completed by the next write")
+    {
+        append("follow.dat", "4 -1");
+        REQUIRE(data_analyzer.refresh());
+        REQUIRE(data_analyzer.results() == Results{{"Sum", 37}, {"Min", 1}, {"Max", 34}});
+
+        append("follow.dat", "0\n");
+        REQUIRE(data_analyzer.refresh());
+        REQUIRE(data_analyzer.results() == Results{{"Sum", 27}, {"Min", -10}, {"Max", 34}});
+        REQUIRE(data_analyzer.value_count() == 4);
+
+        REQUIRE_FALSE(data_analyzer.refresh());
+    }
+
+    SECTION("finish parses the last number")
+    {
+        data_analyzer.finish();
+        REQUIRE(data_analyzer.results() == Results{{"Sum", 6}, {"Min", 1}, {"Max", 3}});
+    }
+
+    SECTION("truncated file is followed from the start")
+    {
+        create("follow.dat", "7\n");
+        REQUIRE(data_analyzer.refresh());
+        REQUIRE(data_analyzer.results() == Results{{"Sum", 7}, {"Min", 7}, {"Max", 7}});
+    }
+
+#ifndef _WIN32
+    SECTION("replaced file is followed from the start")
+    {
+        create("follow_rotated.dat", "10 20 30\n");
+        std::filesystem::rename("follow_rotated.dat", "follow.dat");
+        REQUIRE(data_analyzer.refresh());
+        REQUIRE(data_analyzer.results() == Results{{"Sum", 60}, {"Min", 10}, {"Max", 30}});
+        REQUIRE(data_analyzer.offset() == 9);
+    }
+#endif
+
+    SECTION("stops at invalid token")
+    {
+        append("follow.dat", "\nabc 100\n");
+        data_analyzer.refresh();
+        append("follow.dat", "200\n");
+        REQUIRE_FALSE(data_analyzer.refresh());
+        REQUIRE(data_analyzer.results()[0] == StatResult{"Sum", 6});
+    }
+}
+
+TEST_CASE("FollowDataAnalyzer - small blocks give the same results as text_reader")
+{
+    Data data = Ver_2::text_reader("data.dat");
+
+    create("follow_blocks.dat");
+    Ver_2::FollowDataAnalyzer data_analyzer{"follow_blocks.dat", {Ver_2::Statistics::sum}, Ver_2::text_writer, 3};
+
+    std::ifstream fin{"data.dat", std::ios::binary};
+    std::string text{std::istreambuf_iterator<char>{fin}, std::istreambuf_iterator<char>{}};
+    for (std::size_t pos = 0; pos < text.size(); pos += 5)
+    {
+        append("follow_blocks.dat", text.substr(pos, 5));
+        data_analyzer.refresh();
+    }
+    data_analyzer.finish();
+
+    REQUIRE(data_analyzer.value_count() == data.size());
+    REQUIRE(data_analyzer.results() == Ver_2::Statistics::sum->calculate(data));
+}
+
+TEST_CASE("FollowDataAnalyzer - follow is woken by appends", "[Integration]")
+{
+    create("follow_thread.dat");
+    Ver_2::FollowDataAnalyzer data_analyzer{"follow_thread.dat", {Ver_2::Statistics::sum}};
+
+    std::atomic<double> sum = 0.0;
+    {
+        std::jthread follower{[&](std::stop_token stop) {
+            data_analyzer.follow(stop, std::chrono::milliseconds{10}, [&](const Results& results) { sum = results[0].value; });
+        }};
+
+        for (int i = 1; i <= 10; ++i)
+            append("follow_thread.dat", std::to_string(i) + "\n");
+
+        for (int wait = 0; wait < 500 && sum != 55.0; ++wait)
+            std::this_thread::sleep_for(std::chrono::milliseconds{10});
+    }
+
+    REQUIRE(sum == 55.0);
+}
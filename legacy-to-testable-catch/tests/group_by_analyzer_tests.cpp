@@ -0,0 +1,247 @@
+#include <algorithm>
+#include <catch2/benchmark/catch_benchmark.hpp>
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/generators/catch_generators.hpp>
+#include <fstream>
+#include <group_by_analyzer.hpp>
+#include <iterator>
+#include <map>
+#include <numeric>
+#include <percentiles.hpp>
+#include <random>
+#include <unordered_map>
+
+using namespace std;
+
+namespace
+{
+    std::string file_content(const std::string& file_name)
+    {
+        std::ifstream in{file_name, std::ios::binary};
+        return {std::istreambuf_iterator<char>{in}, std::istreambuf_iterator<char>{}};
+    }
+
+    void write_file(const std::string& file_name, const std::string& content)
+    {
+        std::ofstream out{file_name, std::ios::binary};
+        out << content;
+    }
+}
+
+TEST_CASE("GroupTable")
+{
+    GroupTable table;
+    std::vector<std::string> keys;
+    auto insert = [&](const std::string& key, std::uint64_t hash) {
+        auto [group, inserted] = table.insert(hash, [&](std::uint32_t g) { return keys[g] == key; });
+        if (inserted)
+            keys.push_back(key);
+        return std::pair{group, inserted};
+    };
+    auto find = [&](const std::string& key, std::uint64_t hash) { return table.find(hash, [&](std::uint32_t g) { return keys[g] == key; }); };
+
+    SECTION("groups are numbered in order of insertion")
+    {
+        REQUIRE(insert("a", hash_key("a")) == std::pair{0u, true});
+        REQUIRE(insert("b", hash_key("b")) == std::pair{1u, true});
+        REQUIRE(insert("a", hash_key("a")) == std::pair{0u, false});
+
+        REQUIRE(table.size() == 2);
+        REQUIRE(find("b", hash_key("b")) == 1u);
+        REQUIRE(find("c", hash_key("c")) == std::nullopt);
+    }
+
+    SECTION("keys with the same hash are different groups")
+    {
+        REQUIRE(insert("a", 42) == std::pair{0u, true});
+        REQUIRE(insert("b", 42) == std::pair{1u, true});
+
+        REQUIRE(find("a", 42) == 0u);
+        REQUIRE(find("b", 42) == 1u);
+        REQUIRE(find("c", 42) == std::nullopt);
+    }
+
+    SECTION("table grows")
+    {
+        for (int i = 0; i < 100'000; ++i)
+            insert(std::to_string(i), hash_key(std::to_string(i)));
+
+        REQUIRE(table.size() == 100'000);
+        for (int i = 0; i < 100'000; ++i)
+        {
+            REQUIRE(find(std::to_string(i), hash_key(std::to_string(i))) == static_cast<std::uint32_t>(i));
+            REQUIRE(table.hash_of(i) == hash_key(std::to_string(i)));
+        }
+    }
+}
+
+TEST_CASE("split_on_lines")
+{
+    std::string_view text = "a 1\nbb 2\nccc 3\n";
+
+    REQUIRE(split_on_lines(text, 1) == std::vector<std::size_t>{0, text.size()});
+    REQUIRE(split_on_lines(text, 3) == std::vector<std::size_t>{0, 9, text.size()});
+    REQUIRE(split_on_lines(text, 100) == std::vector<std::size_t>{0, 4, 9, text.size()});
+    REQUIRE(split_on_lines("", 4) == std::vector<std::size_t>{0, 0});
+}
+
+TEST_CASE("GroupByAnalyzer - statistics per key")
+{
+    write_file("group_by.dat", "sensor_1 10\nsensor_2 -1.5\nsensor_1 20\n\n  sensor_3\t+7 \r\nsensor_2 3.5\nsensor_1 30");
+
+    Ver_2::GroupByAnalyzer analyzer{{Ver_2::Statistics::sum, Ver_2::Statistics::min_max}, 1};
+    analyzer.calculate("group_by.dat");
+
+    REQUIRE(analyzer.results().size() == 3);
+    REQUIRE(*analyzer.find("sensor_1") == Results{{"Sum", 60.0}, {"Min", 10.0}, {"Max", 30.0}});
+    REQUIRE(*analyzer.find("sensor_2") == Results{{"Sum", 2.0}, {"Min", -1.5}, {"Max", 3.5}});
+    REQUIRE(*analyzer.find("sensor_3") == Results{{"Sum", 7.0}, {"Min", 7.0}, {"Max", 7.0}});
+    REQUIRE(analyzer.find("sensor_4") == nullptr);
+
+    SECTION("results are saved one line per key and statistic")
+    {
+        Ver_2::GroupByAnalyzer sum_analyzer{{Ver_2::Statistics::sum}, 1};
+        sum_analyzer.calculate("group_by.dat");
+        sum_analyzer.save_results("group_by_results.txt");
+
+        std::string expected;
+        for (const auto& group : sum_analyzer.results())
+            expected += group.key + ": Sum = " + std::to_string(static_cast<int>(group.results.front().value)) + "\n";
+        REQUIRE(file_content("group_by_results.txt") == expected);
+    }
+
+    SECTION("statistics that are not streaming get values of the group")
+    {
+        Ver_2::GroupByAnalyzer percentiles_analyzer{{Ver_2::Statistics::percentiles}, 1};
+        percentiles_analyzer.calculate("group_by.dat");
+
+        REQUIRE(*percentiles_analyzer.find("sensor_1") == Ver_2::Statistics::percentiles->calculate(Data{10.0, 20.0, 30.0}));
+    }
+}
+
+TEST_CASE("GroupByAnalyzer - rows after the first invalid row are ignored")
+{
+    write_file("group_by_invalid.dat", "a 1\nb 2\nc\nd 4\n");
+
+    Ver_2::GroupByAnalyzer analyzer{{Ver_2::Statistics::sum}, 4, 1};
+    analyzer.calculate("group_by_invalid.dat");
+
+    REQUIRE(analyzer.results().size() == 2);
+    REQUIRE(*analyzer.find("a") == Results{{"Sum", 1.0}});
+    REQUIRE(*analyzer.find("b") == Results{{"Sum", 2.0}});
+    REQUIRE(analyzer.find("d") == nullptr);
+}
+
+TEST_CASE("GroupByAnalyzer - empty file")
+{
+    write_file("group_by_empty.dat", "");
+
+    Ver_2::GroupByAnalyzer analyzer{{Ver_2::Statistics::sum}};
+    analyzer.calculate("group_by_empty.dat");
+
+    REQUIRE(analyzer.results().empty());
+    REQUIRE(analyzer.find("a") == nullptr);
+}
+
+TEST_CASE("GroupByAnalyzer - partial tables of threads are merged")
+{
+    std::mt19937_64 rnd_gen{42};
+    std::uniform_int_distribution<int> key_distr{0, 999};
+    std::uniform_int_distribution<int> value_distr{-1000, 1000};
+
+    std::map<std::string, Data> expected;
+    std::string content;
+    for (int i = 0; i < 20'000; ++i)
+    {
+        const std::string key = "key_" + std::to_string(key_distr(rnd_gen));
+        const int value = value_distr(rnd_gen);
+        expected[key].push_back(value);
+        content += key + " " + std::to_string(value) + "\n";
+    }
+    write_file("group_by_random.dat", content);
+
+    Ver_2::GroupByAnalyzer single_thread{{Ver_2::Statistics::sum, Ver_2::Statistics::avg}, 1};
+    single_thread.calculate("group_by_random.dat");
+
+    auto thread_count = GENERATE(values<std::size_t>({2, 3, 8}));
+    Ver_2::GroupByAnalyzer analyzer{{Ver_2::Statistics::sum, Ver_2::Statistics::avg}, thread_count, 1000};
+    analyzer.calculate("group_by_random.dat");
+
+    REQUIRE(analyzer.results().size() == expected.size());
+    for (const auto& [key, values] : expected)
+    {
+        const double sum = std::accumulate(values.begin(), values.end(), 0.0);
+        REQUIRE(*analyzer.find(key) == Results{{"Sum", sum}, {"Avg", sum / values.size()}});
+    }
+
+    SECTION("order of groups does not depend on the number of threads")
+    {
+        REQUIRE(analyzer.results() == single_thread.results());
+    }
+}
+
+TEST_CASE("GroupByAnalyzer - benchmark", "[.][benchmark]")
+{
+    const int row_count = 10'000'000;
+
+    auto write_rows = [](const std::string& file_name, int row_count, int key_count) {
+        std::mt19937_64 rnd_gen{42};
+        std::uniform_int_distribution<int> value_distr{-1000, 1000};
+        std::vector<int> keys(row_count);
+        for (int i = 0; i < row_count; ++i)
+            keys[i] = i % key_count;
+        std::shuffle(keys.begin(), keys.end(), rnd_gen);
+
+        std::ofstream out{file_name, std::ios::binary};
+        for (int key : keys)
+            out << "sensor_" << key << " " << value_distr(rnd_gen) << "\n";
+    };
+    write_rows("group_by_distinct.dat", row_count, row_count);
+    write_rows("group_by_sensors.dat", row_count, 1000);
+
+    // baseline - node based map of vectors of values
+    auto unordered_map_group_by = [](const std::string& file_name) {
+        MappedFile file{file_name};
+        std::string_view text = file.view();
+
+        std::unordered_map<std::string, Data> groups;
+        for (std::size_t pos = 0; pos < text.size();)
+        {
+            const std::size_t separator = text.find(' ', pos);
+            const std::size_t end = text.find('\n', separator);
+            double value;
+            std::from_chars(text.data() + separator + 1, text.data() + end, value);
+            groups[std::string{text.substr(pos, separator - pos)}].push_back(value);
+            pos = end + 1;
+        }
+
+        std::size_t count = 0;
+        for (const auto& [key, values] : groups)
+            count += Ver_2::Statistics::avg->calculate(values).size();
+        return count;
+    };
+
+    BENCHMARK("std::unordered_map - 10M distinct keys")
+    {
+        return unordered_map_group_by("group_by_distinct.dat");
+    };
+
+    BENCHMARK("GroupByAnalyzer - 10M distinct keys")
+    {
+        Ver_2::GroupByAnalyzer analyzer{{Ver_2::Statistics::avg}};
+        analyzer.calculate("group_by_distinct.dat");
+        return analyzer.results().size();
+    };
+
+    BENCHMARK("std::unordered_map - 1000 keys")
+    {
+        return unordered_map_group_by("group_by_sensors.dat");
+    };
+
+    BENCHMARK("GroupByAnalyzer - 1000 keys")
+    {
+        Ver_2::GroupByAnalyzer analyzer{{Ver_2::Statistics::avg}};
+        analyzer.calculate("group_by_sensors.dat");
+        return analyzer.results().size();
+    };
+}
@@ -0,0 +1,137 @@
+#include <catch2/benchmark/catch_benchmark.hpp>
+#include <catch2/catch_test_macros.hpp>
+#include <cmath>
+#include <histogram.hpp>
+#include <limits>
+#include <random>
+#include <stdexcept>
+#include <tuple>
+#include "test_data.hpp"
+
+using namespace std;
+
+namespace
+{
+    const std::normal_distribution<double> data_distr{50.0, 20.0};
+}
+
+TEST_CASE("Histogram - fixed-width bins")
+{
+    Data data = {-1, 0, 2.5, 4.99, 5, 9.99, 10, std::nan(""), 7};
+
+    Ver_2::Histogram histogram{0.0, 10.0, 2};
+
+    REQUIRE(histogram.calculate(data) == Results{{"Underflow", 2.0}, {"Bin[0, 5)", 3.0}, {"Bin[5, 10)", 3.0}, {"Overflow", 1.0}});
+}
+
+TEST_CASE("Histogram - explicit edges")
+{
+    Data data = {-1, 0, 0.5, 1, 99, 100, 1e9, std::nan("")};
+
+    Ver_2::Histogram histogram{{0.0, 1.0, 100.0}};
+
+    REQUIRE(histogram.calculate(data) == Results{{"Underflow", 2.0}, {"Bin[0, 1)", 2.0}, {"Bin[1, 100)", 2.0}, {"Overflow", 2.0}});
+}
+
+TEST_CASE("Histogram - invalid bins")
+{
+    REQUIRE_THROWS_AS(Ver_2::Histogram(1.0, 1.0, 10), std::invalid_argument);
+    REQUIRE_THROWS_AS(Ver_2::Histogram(0.0, 1.0, 0), std::invalid_argument);
+    REQUIRE_THROWS_AS(Ver_2::Histogram(0.0, 1.0, std::numeric_limits<std::int32_t>::max() - 1), std::invalid_argument);
+    REQUIRE_THROWS_AS(Ver_2::Histogram(1e16, 1e16 + 4, 3), std::invalid_argument);
+    REQUIRE_THROWS_AS(Ver_2::Histogram(std::vector<double>{1.0}), std::invalid_argument);
+    REQUIRE_THROWS_AS(Ver_2::Histogram(std::vector<double>{0.0, 2.0, 1.0}), std::invalid_argument);
+}
+
+TEST_CASE("Histogram - fixed-width bins agree with explicit edges")
+{
+    Data data = make_random_data(100'003, data_distr);
+
+    Ver_2::Histogram fixed_width{0.0, 100.0, 40};
+    Ver_2::Histogram explicit_edges{fixed_width.edges()};
+
+    REQUIRE(fixed_width.calculate(data) == explicit_edges.calculate(data));
+
+    SECTION("values next to edges land in the bin whose edges contain them")
+    {
+        for (auto [low, high, bin_count] : {std::tuple{0.0, 100.0, 40}, std::tuple{-1.0, 0.7, 3}, std::tuple{0.1, 0.3, 7}, std::tuple{1e6, 1e6 + 1, 49}})
+        {
+            Ver_2::Histogram fixed_width{low, high, static_cast<std::size_t>(bin_count)};
+            Ver_2::Histogram explicit_edges{fixed_width.edges()};
+
+            Data edge_data;
+            for (double edge : fixed_width.edges())
+                edge_data.insert(edge_data.end(), {std::nextafter(edge, -1e9), edge, std::nextafter(edge, 1e9)});
+            edge_data.resize(edge_data.size() * 8, edge_data[1]); // some full lanes for SIMD kernels
+
+            REQUIRE(fixed_width.calculate(edge_data) == explicit_edges.calculate(edge_data));
+        }
+    }
+}
+
+TEST_CASE("Histogram - parallel and sharded results are the same as fused")
+{
+    Data data = make_random_data(200'000, data_distr);
+    auto expected = Ver_2::calculate_fused({Ver_2::Statistics::histogram}, data);
+
+    SECTION("parallel")
+    {
+        REQUIRE(Ver_2::calculate_parallel({Ver_2::Statistics::histogram}, data, 4) == expected);
+    }
+
+    SECTION("serialized shards")
+    {
+        std::vector<std::string> states;
+        for (std::size_t offset = 0; offset < data.size(); offset += 50'000)
+        {
+            auto shard = Ver_2::Statistics::histogram->make_accumulator();
+            shard->update(std::span<const double>{data}.subspan(offset, 50'000));
+            states.push_back(shard->serialize());
+        }
+
+        REQUIRE(Ver_2::merge_states(*Ver_2::Statistics::histogram, states) == expected);
+    }
+
+    SECTION("bins must match")
+    {
+        auto accumulator = Ver_2::Statistics::histogram->make_accumulator();
+        auto other = Ver_2::Histogram{0.0, 100.0, 20}.make_accumulator();
+
+        REQUIRE_THROWS_AS(accumulator->merge(*other), std::invalid_argument);
+    }
+}
+
+TEST_CASE("Histogram - plug into DataAnalyzer", "[Integration]")
+{
+    Ver_2::DataAnalyzer data_analyzer(Ver_2::Statistics::histogram);
+    data_analyzer.load_data("data.dat");
+    data_analyzer.calculate();
+
+    REQUIRE(data_analyzer.results().size() == 12);
+    REQUIRE(data_analyzer.results()[1].description == "Bin[0, 10)");
+}
+
+TEST_CASE("Histogram - benchmark", "[.][benchmark]")
+{
+    Data data = make_random_data(100'000'000, data_distr);
+
+    BENCHMARK("Sum")
+    {
+        return Ver_2::calculate_fused({Ver_2::Statistics::sum}, data);
+    };
+
+    BENCHMARK("Histogram - fixed width")
+    {
+        return Ver_2::calculate_fused({Ver_2::Statistics::histogram}, data);
+    };
+
+    BENCHMARK("Histogram - fixed width, parallel")
+    {
+        return Ver_2::calculate_parallel({Ver_2::Statistics::histogram}, data, std::thread::hardware_concurrency());
+    };
+
+    BENCHMARK("Histogram - explicit edges")
+    {
+        return Ver_2::Histogram{Ver_2::Statistics::histogram->edges()}.calculate(data);
+    };
+}
@@ -0,0 +1,148 @@
+#include <algorithm>
+#include <bit>
+#include <catch2/benchmark/catch_benchmark.hpp>
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/matchers/catch_matchers_floating_point.hpp>
+#include <cmath>
+#include <kernels.hpp>
+#include <limits>
+#include <numeric>
+#include <random>
+#include <vector>
+#include "test_data.hpp"
+
+using namespace std;
+
+namespace
+{
+    const std::uniform_real_distribution<double> data_distr{-1e6, 1e6};
+
+    std::vector<Kernels::Isa> supported_isas()
+    {
+        std::vector<Kernels::Isa> isas;
+        for (auto isa : {Kernels::Isa::scalar, Kernels::Isa::sse2, Kernels::Isa::avx2, Kernels::Isa::avx512})
+            if (Kernels::is_supported(isa))
+                isas.push_back(isa);
+        return isas;
+    }
+}
+
+TEST_CASE("Kernels - results are bit-compatible for every supported ISA")
+{
+    for (std::size_t size : {1, 2, 15, 16, 17, 33, 100, 100'003})
+    {
+        auto data = make_random_data(size, data_distr);
+
+        double expected_sum = Kernels::sum(data, Kernels::Isa::scalar);
+        auto expected_min_max = Kernels::min_max(data, Kernels::Isa::scalar);
+
+        for (auto isa : supported_isas())
+        {
+            INFO("ISA: " << Kernels::to_string(isa) << ", size: " << size);
+
+            REQUIRE(std::bit_cast<std::uint64_t>(Kernels::sum(data, isa)) == std::bit_cast<std::uint64_t>(expected_sum));
+
+            auto [min, max] = Kernels::min_max(data, isa);
+            REQUIRE(min == expected_min_max.min);
+            REQUIRE(max == expected_min_max.max);
+        }
+    }
+}
+
+TEST_CASE("Kernels - results match standard algorithms")
+{
+    auto data = make_random_data(10'001, data_distr);
+
+    REQUIRE_THAT(Kernels::sum(data), Catch::Matchers::WithinRel(std::accumulate(data.begin(), data.end(), 0.0), 1e-12));
+
+    auto [min, max] = Kernels::min_max(data);
+    REQUIRE(min == *std::min_element(data.begin(), data.end()));
+    REQUIRE(max == *std::max_element(data.begin(), data.end()));
+}
+
+TEST_CASE("Kernels - histogram counts are the same for every supported ISA")
+{
+    auto data = make_random_data(100'003, data_distr);
+    data.insert(data.end(), {-1e5, 1e5, std::nan(""), -std::numeric_limits<double>::infinity(), std::numeric_limits<double>::infinity()});
+
+    std::vector<double> bounds{std::nan("")};
+    for (int i = 0; i <= 60; ++i) // width of bins is not exact
+        bounds.push_back(i < 60 ? -1e5 + i * (2e5 / 60) : 1e5);
+    bounds.push_back(std::nan(""));
+    const Kernels::HistogramEdges edges{-1e5, 60 / 2e5, bounds, 1e-9};
+
+    // values next to edges, where rounding of (value - low) * scale can miss the bin
+    for (std::size_t i = 1; i + 1 < bounds.size(); ++i)
+        data.insert(data.end(), {std::nextafter(bounds[i], -1e6), bounds[i], std::nextafter(bounds[i], 1e6)});
+
+    Kernels::HistogramBins expected_bins{60 + 2};
+    Kernels::histogram(data, edges, expected_bins, Kernels::Isa::scalar);
+    const std::vector<std::uint64_t> expected = expected_bins.counts();
+
+    REQUIRE(std::accumulate(expected.begin(), expected.end(), std::uint64_t{0}) == data.size());
+    for (std::size_t bin = 0; bin < expected.size(); ++bin)
+    {
+        const auto in_bin = std::count_if(data.begin(), data.end(), [&](double value) {
+            return bin == 0 ? !(value >= bounds[1]) : value >= bounds[bin] && !(value >= bounds[bin + 1]);
+        });
+        REQUIRE(expected[bin] == static_cast<std::uint64_t>(in_bin));
+    }
+
+    for (auto isa : supported_isas())
+    {
+        INFO("ISA: " << Kernels::to_string(isa));
+
+        Kernels::HistogramBins bins{60 + 2};
+        Kernels::histogram(data, edges, bins, isa);
+        REQUIRE(bins.counts() == expected);
+
+        // local bins accumulate from call to call
+        Kernels::histogram(data, edges, bins, isa);
+        const std::vector<std::uint64_t> counts = bins.counts();
+        for (std::size_t i = 0; i < expected.size(); ++i)
+            REQUIRE(counts[i] == 2 * expected[i]);
+    }
+}
+
+TEST_CASE("Kernels - spans shorter than lane count use scalar kernel by default")
+{
+    REQUIRE(Kernels::effective_isa(Kernels::lane_count - 1) == Kernels::Isa::scalar);
+    REQUIRE(Kernels::effective_isa(Kernels::lane_count) == Kernels::active_isa());
+}
+
+TEST_CASE("Kernels - sum of empty range is zero")
+{
+    REQUIRE(Kernels::sum(std::span<const double>{}) == 0.0);
+}
+
+TEST_CASE("Kernels - benchmark", "[.][benchmark]")
+{
+    for (std::size_t size : {1'000, 64'000, 1'000'000, 16'000'000})
+    {
+        auto data = make_random_data(size, data_distr);
+        const std::string suffix = " - " + std::to_string(size);
+
+        BENCHMARK("std::accumulate" + suffix)
+        {
+            return std::accumulate(data.begin(), data.end(), 0.0);
+        };
+
+        BENCHMARK("std::min_element + std::max_element" + suffix)
+        {
+            return *std::min_element(data.begin(), data.end()) + *std::max_element(data.begin(), data.end());
+        };
+
+        for (auto isa : supported_isas())
+        {
+            BENCHMARK(std::string("Kernels::sum - ") + Kernels::to_string(isa) + suffix)
+            {
+                return Kernels::sum(data, isa);
+            };
+
+            BENCHMARK(std::string("Kernels::min_max - ") + Kernels::to_string(isa) + suffix)
+            {
+                return Kernels::min_max(data, isa).min;
+            };
+        }
+    }
+}
@@ -0,0 +1,153 @@
+#include <catch2/benchmark/catch_benchmark.hpp>
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/matchers/catch_matchers_floating_point.hpp>
+#include <data_analyzer.hpp>
+#include <random>
+#include "test_data.hpp"
+
+using namespace std;
+using Catch::Matchers::WithinRel;
+
+namespace
+{
+    const std::normal_distribution<double> data_distr{1e6, 10.0};
+
+    void require_close(const Results& actual, const Results& expected)
+    {
+        REQUIRE(actual.size() == expected.size());
+        for (std::size_t i = 0; i < actual.size(); ++i)
+        {
+            REQUIRE(actual[i].description == expected[i].description);
+            REQUIRE_THAT(actual[i].value, WithinRel(expected[i].value, 1e-9));
+        }
+    }
+
+    const std::vector<std::shared_ptr<Ver_2::IStatistics>> all_stats = {
+        Ver_2::Statistics::avg, Ver_2::Statistics::min_max, Ver_2::Statistics::sum, Ver_2::Statistics::variance};
+}
+
+TEST_CASE("Variance")
+{
+    Data data = {2, 4, 4, 4, 5, 5, 7, 9};
+
+    REQUIRE(Ver_2::Statistics::variance->calculate(data) == Results{{"Variance", 4.0}});
+}
+
+TEST_CASE("Variance - stable for large mean and small spread")
+{
+    Data data = make_random_data(100'000, data_distr);
+
+    double mean = std::accumulate(data.begin(), data.end(), 0.0L) / data.size();
+    long double m2 = 0.0L;
+    for (double d : data)
+        m2 += (d - mean) * (d - mean);
+
+    REQUIRE_THAT(Ver_2::Statistics::variance->calculate(data)[0].value, WithinRel(static_cast<double>(m2 / data.size()), 1e-9));
+}
+
+TEST_CASE("Accumulators - merged partial states give the same results as one pass")
+{
+    Data data = make_random_data(10'001, data_distr);
+    std::span<const double> values{data};
+
+    for (const auto& stat : all_stats)
+    {
+        auto streaming_stat = std::dynamic_pointer_cast<Ver_2::IStreamingStatistics>(stat);
+
+        auto left = streaming_stat->make_accumulator();
+        auto right = streaming_stat->make_accumulator();
+        auto empty = streaming_stat->make_accumulator();
+        left->update(values.first(3'000));
+        right->update(values.subspan(3'000));
+        left->merge(*right);
+        left->merge(*empty);
+
+        require_close(left->finalize(), stat->calculate(data));
+    }
+}
+
+TEST_CASE("Accumulators - merging different kinds throws")
+{
+    Ver_2::Sum::Accumulator sum;
+    Ver_2::Avg::Accumulator avg;
+
+    REQUIRE_THROWS_AS(sum.merge(avg), std::invalid_argument);
+}
+
+TEST_CASE("Accumulators - serialized states of shards can be merged")
+{
+    Data data = make_random_data(1'000, data_distr);
+    std::span<const double> values{data};
+
+    for (const auto& stat : all_stats)
+    {
+        auto streaming_stat = std::dynamic_pointer_cast<Ver_2::IStreamingStatistics>(stat);
+
+        std::vector<std::string> states;
+        for (std::size_t offset = 0; offset < data.size(); offset += 300)
+        {
+            auto shard = streaming_stat->make_accumulator();
+            shard->update(values.subspan(offset, std::min<std::size_t>(300, data.size() - offset)));
+            states.push_back(shard->serialize());
+        }
+
+        require_close(Ver_2::merge_states(*streaming_stat, states), stat->calculate(data));
+    }
+}
+
+TEST_CASE("Accumulators - deserializing state of different kind throws")
+{
+    Ver_2::Sum::Accumulator sum;
+    Ver_2::MinMax::Accumulator min_max;
+
+    REQUIRE_THROWS_AS(min_max.deserialize(sum.serialize()), std::invalid_argument);
+    REQUIRE_THROWS_AS(sum.deserialize(sum.serialize().substr(0, 10)), std::runtime_error);
+}
+
+TEST_CASE("Ver_2::DataAnalyzer - calculate_parallel")
+{
+    Data data = make_random_data(100'000, data_distr);
+
+    Ver_2::DataAnalyzer data_analyzer(Ver_2::Statistics::avg, [&data](const std::string&) { return data; });
+    data_analyzer.load_data("random");
+    data_analyzer.set_statistics(all_stats);
+
+    SECTION("gives the same results as one pass")
+    {
+        for (std::size_t thread_count : {1, 3, 8})
+        {
+            Ver_2::DataAnalyzer expected(Ver_2::Statistics::avg, [&data](const std::string&) { return data; });
+            expected.load_data("random");
+            expected.set_statistics(all_stats);
+            expected.calculate();
+
+            data_analyzer.load_data("random");
+            data_analyzer.calculate_parallel(thread_count);
+
+            require_close(data_analyzer.results(), expected.results());
+        }
+    }
+
+    SECTION("empty data")
+    {
+        REQUIRE(Ver_2::calculate_parallel({Ver_2::Statistics::sum}, Data{}, 4) == Results{{"Sum", 0.0}});
+    }
+}
+
+TEST_CASE("calculate_parallel - benchmark", "[.][benchmark]")
+{
+    Data data = make_random_data(32'000'000, data_distr);
+
+    BENCHMARK("calculate_fused")
+    {
+        return Ver_2::calculate_fused(all_stats, data);
+    };
+
+    for (std::size_t thread_count : {2, 4, 8, 16})
+    {
+        BENCHMARK("calculate_parallel - " + std::to_string(thread_count) + " threads")
+        {
+            return Ver_2::calculate_parallel(all_stats, data, thread_count);
+        };
+    }
+}
@@ -0,0 +1,295 @@
+#include <async_reader.hpp>
+#include <binary_format.hpp>
+#include <catch2/benchmark/catch_benchmark.hpp>
+#include <catch2/catch_test_macros.hpp>
+#include <compressed_format.hpp>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <metrics.hpp>
+#include <mmap_reader.hpp>
+#include <numeric>
+#include <parallel_reader.hpp>
+#include <random>
+#include <streaming_data_analyzer.hpp>
+#include <thread>
+
+using namespace std;
+using Metrics::Phase;
+
+namespace
+{
+    std::string file_content(const std::string& file_name)
+    {
+        std::ifstream in{file_name, std::ios::binary};
+        return {std::istreambuf_iterator<char>{in}, std::istreambuf_iterator<char>{}};
+    }
+
+    void analyze(Ver_2::DataAnalyzer& data_analyzer)
+    {
+        data_analyzer.load_data("data.dat");
+        data_analyzer.calculate();
+        data_analyzer.save_results("metrics_results.txt");
+    }
+}
+
+TEST_CASE("DataAnalyzer - metrics are disabled by default")
+{
+    Ver_2::DataAnalyzer data_analyzer(Ver_2::Statistics::sum, mmap_reader);
+    analyze(data_analyzer);
+
+    const auto& metrics = data_analyzer.metrics();
+    for (const auto& phase : metrics.phases)
+    {
+        REQUIRE(phase.calls == 0);
+        REQUIRE(phase.nanoseconds == 0);
+    }
+    REQUIRE(metrics.bytes_read == 0);
+    REQUIRE(metrics.values_parsed == 0);
+    REQUIRE(metrics.allocations == 0);
+}
+
+TEST_CASE("DataAnalyzer - metrics of phases")
+{
+    Ver_2::DataAnalyzer data_analyzer(Ver_2::Statistics::sum, mmap_reader);
+    data_analyzer.enable_metrics();
+
+    SECTION("every phase is counted")
+    {
+        analyze(data_analyzer);
+
+        const auto& metrics = data_analyzer.metrics();
+        REQUIRE(metrics.phase(Phase::load).calls == 1);
+        REQUIRE(metrics.phase(Phase::parse).calls == 1);
+        REQUIRE(metrics.phase(Phase::calculate).calls == 1);
+        REQUIRE(metrics.phase(Phase::save).calls == 1);
+        REQUIRE(metrics.phase(Phase::parse).nanoseconds > 0);
+    }
+
+    SECTION("reads, values and allocations are counted")
+    {
+        analyze(data_analyzer);
+
+        const auto& metrics = data_analyzer.metrics();
+        REQUIRE(metrics.bytes_read == std::filesystem::file_size("data.dat"));
+        REQUIRE(metrics.values_parsed == 100);
+        REQUIRE(metrics.allocations > 0);
+        REQUIRE(metrics.allocated_bytes >= 100 * sizeof(double));
+    }
+
+    SECTION("metrics accumulate until reset")
+    {
+        analyze(data_analyzer);
+        analyze(data_analyzer);
+
+        REQUIRE(data_analyzer.metrics().phase(Phase::load).calls == 2);
+        REQUIRE(data_analyzer.metrics().values_parsed == 200);
+
+        data_analyzer.reset_metrics();
+        REQUIRE(data_analyzer.metrics().phase(Phase::load).calls == 0);
+        REQUIRE(data_analyzer.metrics().values_parsed == 0);
+    }
+
+    SECTION("disabling stops collection")
+    {
+        analyze(data_analyzer);
+        data_analyzer.enable_metrics(false);
+        analyze(data_analyzer);
+
+        REQUIRE(data_analyzer.metrics().phase(Phase::load).calls == 1);
+    }
+}
+
+TEST_CASE("DataAnalyzer - metrics of readers")
+{
+    SECTION("text_reader")
+    {
+        Ver_2::DataAnalyzer data_analyzer(Ver_2::Statistics::sum);
+        data_analyzer.enable_metrics();
+        data_analyzer.load_data("data.dat");
+
+        REQUIRE(data_analyzer.metrics().bytes_read == std::filesystem::file_size("data.dat"));
+        REQUIRE(data_analyzer.metrics().values_parsed == 100);
+        REQUIRE(data_analyzer.metrics().phase(Phase::parse).calls == 1);
+        REQUIRE(data_analyzer.metrics().allocations > 0);
+        REQUIRE(data_analyzer.metrics().allocated_bytes >= 100 * sizeof(double));
+    }
+
+    SECTION("binary_reader")
+    {
+        binary_writer("metrics_data.bin", Ver_2::text_reader("data.dat"));
+
+        Ver_2::DataAnalyzer data_analyzer(Ver_2::Statistics::sum, binary_reader);
+        data_analyzer.enable_metrics();
+        data_analyzer.load_data("metrics_data.bin");
+
+        REQUIRE(data_analyzer.metrics().bytes_read == std::filesystem::file_size("metrics_data.bin"));
+        REQUIRE(data_analyzer.metrics().values_parsed == 100);
+        REQUIRE(data_analyzer.metrics().allocations == 1);
+        REQUIRE(data_analyzer.metrics().allocated_bytes == 100 * sizeof(double));
+    }
+
+    SECTION("compressed_reader")
+    {
+        compressed_writer("metrics_data.tdcz", Ver_2::text_reader("data.dat"));
+
+        Ver_2::DataAnalyzer data_analyzer(Ver_2::Statistics::sum, compressed_reader);
+        data_analyzer.enable_metrics();
+        data_analyzer.load_data("metrics_data.tdcz");
+
+        REQUIRE(data_analyzer.metrics().bytes_read == std::filesystem::file_size("metrics_data.tdcz"));
+        REQUIRE(data_analyzer.metrics().values_parsed == 100);
+    }
+
+    SECTION("parallel_reader - counters of workers are added after the join")
+    {
+        Data data(300'000);
+        std::iota(data.begin(), data.end(), 0.0);
+        {
+            std::ofstream out{"metrics_parallel.dat"};
+            for (double value : data)
+                out << value << "\n";
+        }
+
+        Ver_2::DataAnalyzer data_analyzer(Ver_2::Statistics::sum, ParallelReader{4, 64 * 1024});
+        data_analyzer.enable_metrics();
+        data_analyzer.load_data("metrics_parallel.dat");
+
+        const auto& metrics = data_analyzer.metrics();
+        REQUIRE(metrics.bytes_read == std::filesystem::file_size("metrics_parallel.dat"));
+        REQUIRE(metrics.values_parsed == data.size());
+        REQUIRE(metrics.phase(Phase::parse).calls == 1);
+        REQUIRE(metrics.phase(Phase::parse).nanoseconds > 0);
+        REQUIRE(metrics.allocations == 4 + 1); // chunk of every worker and the joined data
+        REQUIRE(metrics.allocated_bytes >= 2 * data.size() * sizeof(double));
+    }
+
+    SECTION("async_text_reader")
+    {
+        Ver_2::DataAnalyzer data_analyzer(Ver_2::Statistics::sum, async_text_reader);
+        data_analyzer.enable_metrics();
+        data_analyzer.load_data("data.dat");
+
+        REQUIRE(data_analyzer.metrics().bytes_read == std::filesystem::file_size("data.dat"));
+        REQUIRE(data_analyzer.metrics().values_parsed == 100);
+        REQUIRE(data_analyzer.metrics().allocations > 0);
+        REQUIRE(data_analyzer.metrics().allocated_bytes >= 100 * sizeof(double));
+    }
+
+    SECTION("text_stream_reader")
+    {
+        Metrics::AnalyzerMetrics metrics;
+        {
+            Metrics::Scope scope{&metrics};
+            text_stream_reader("data.dat", [](std::span<const double>) {});
+        }
+
+        REQUIRE(metrics.bytes_read == std::filesystem::file_size("data.dat"));
+        REQUIRE(metrics.values_parsed == 100);
+    }
+}
+
+TEST_CASE("Metrics - nested phases")
+{
+    Metrics::AnalyzerMetrics metrics;
+    {
+        Metrics::Scope scope{&metrics};
+        Metrics::ScopedPhase load{Phase::load};
+        {
+            Metrics::ScopedPhase parse{Phase::parse};
+            std::this_thread::sleep_for(std::chrono::milliseconds(20));
+        }
+    }
+
+    SECTION("time of nested phase is excluded from outer phase")
+    {
+        REQUIRE(metrics.phase(Phase::load).calls == 1);
+        REQUIRE(metrics.phase(Phase::parse).calls == 1);
+        REQUIRE(metrics.phase(Phase::parse).seconds() >= 0.02);
+        REQUIRE(metrics.phase(Phase::load).nanoseconds < metrics.phase(Phase::parse).nanoseconds);
+    }
+
+    SECTION("collector is restored at the end of scope")
+    {
+        REQUIRE(Metrics::collector == nullptr);
+        REQUIRE(Metrics::current_phase == nullptr);
+    }
+}
+
+TEST_CASE("Metrics - text formats")
+{
+    Metrics::AnalyzerMetrics metrics;
+    metrics.phase(Phase::load) = {1, 1'500'000'000};
+    metrics.phase(Phase::parse) = {2, 250'000'000};
+    metrics.bytes_read = 1024;
+    metrics.values_parsed = 100;
+    metrics.allocations = 3;
+    metrics.allocated_bytes = 800;
+
+    SECTION("Prometheus")
+    {
+        const std::string text = Metrics::to_prometheus(metrics);
+
+        REQUIRE(text.find("# TYPE data_analyzer_phase_seconds_total counter\n") != std::string::npos);
+        REQUIRE(text.find("data_analyzer_phase_seconds_total{phase=\"load\"} 1.5\n") != std::string::npos);
+        REQUIRE(text.find("data_analyzer_phase_calls_total{phase=\"parse\"} 2\n") != std::string::npos);
+        REQUIRE(text.find("data_analyzer_phase_calls_total{phase=\"save\"} 0\n") != std::string::npos);
+        REQUIRE(text.find("data_analyzer_bytes_read_total 1024\n") != std::string::npos);
+        REQUIRE(text.find("data_analyzer_values_parsed_total 100\n") != std::string::npos);
+        REQUIRE(text.find("data_analyzer_allocations_total 3\n") != std::string::npos);
+        REQUIRE(text.find("data_analyzer_allocated_bytes_total 800\n") != std::string::npos);
+        REQUIRE(Metrics::to_prometheus(metrics, "app").find("app_bytes_read_total 1024\n") != std::string::npos);
+    }
+
+    SECTION("JSON")
+    {
+        REQUIRE(Metrics::to_json(metrics)
+            == "{\"phases\":{\"load\":{\"calls\":1,\"seconds\":1.5},\"parse\":{\"calls\":2,\"seconds\":0.25},"
+               "\"calculate\":{\"calls\":0,\"seconds\":0},\"save\":{\"calls\":0,\"seconds\":0}},"
+               "\"bytes_read\":1024,\"values_parsed\":100,\"allocations\":3,\"allocated_bytes\":800}");
+    }
+
+    SECTION("saved by DataAnalyzer")
+    {
+        Ver_2::DataAnalyzer data_analyzer(Ver_2::Statistics::sum, mmap_reader);
+        data_analyzer.enable_metrics();
+        data_analyzer.load_data("data.dat");
+
+        data_analyzer.save_metrics("metrics.prom");
+        data_analyzer.save_metrics("metrics.json", Metrics::Format::json);
+
+        REQUIRE(file_content("metrics.prom") == Metrics::to_prometheus(data_analyzer.metrics()));
+        REQUIRE(file_content("metrics.json") == Metrics::to_json(data_analyzer.metrics()) + "\n");
+    }
+}
+
+TEST_CASE("DataAnalyzer - metrics overhead benchmark", "[.][benchmark]")
+{
+    {
+        std::mt19937_64 rnd_gen{42};
+        std::uniform_real_distribution<double> distr{-1000.0, 1000.0};
+        std::ofstream out{"metrics_benchmark.dat"};
+        for (int i = 0; i < 1'000'000; ++i)
+            out << distr(rnd_gen) << "\n";
+    }
+
+    auto run = [](bool enabled) {
+        Ver_2::DataAnalyzer data_analyzer(Ver_2::Statistics::avg, mmap_reader, [](const std::string&, const Results&) {});
+        data_analyzer.set_statistics({Ver_2::Statistics::avg, Ver_2::Statistics::min_max});
+        data_analyzer.enable_metrics(enabled);
+        data_analyzer.load_data("metrics_benchmark.dat");
+        data_analyzer.calculate();
+        data_analyzer.save_results("");
+        return data_analyzer.results().size();
+    };
+
+    BENCHMARK("load, calculate, save - metrics disabled")
+    {
+        return run(false);
+    };
+
+    BENCHMARK("load, calculate, save - metrics enabled")
+    {
+        return run(true);
+    };
+}
@@ -0,0 +1,81 @@
+#include <catch2/benchmark/catch_benchmark.hpp>
+#include <catch2/catch_test_macros.hpp>
+#include <mmap_reader.hpp>
+#include <random>
+
+using namespace std;
+
+namespace
+{
+    void write_text_file(const std::string& file_name, const std::string& contents)
+    {
+        std::ofstream out{file_name, std::ios::binary};
+        out << contents;
+    }
+}
+
+TEST_CASE("mmap_reader - reads the same data as text_reader")
+{
+    REQUIRE(mmap_reader("data.dat") == Ver_1::text_reader("data.dat"));
+}
+
+TEST_CASE("mmap_reader - parsing")
+{
+    SECTION("mixed whitespace and number formats")
+    {
+        write_text_file("mmap_reader_mixed.dat", "  1\t-2.5\r\n+3 4e2\n\n0.125");
+
+        REQUIRE(mmap_reader("mmap_reader_mixed.dat") == Data{1.0, -2.5, 3.0, 400.0, 0.125});
+    }
+
+    SECTION("stops at the first token that is not a number")
+    {
+        write_text_file("mmap_reader_garbage.dat", "1\n2\nabc\n3\n");
+
+        REQUIRE(mmap_reader("mmap_reader_garbage.dat") == Data{1.0, 2.0});
+    }
+
+    SECTION("empty file")
+    {
+        write_text_file("mmap_reader_empty.dat", "");
+
+        REQUIRE(mmap_reader("mmap_reader_empty.dat").empty());
+    }
+
+    SECTION("missing file throws")
+    {
+        REQUIRE_THROWS_AS(mmap_reader("not_existing.dat"), std::runtime_error);
+    }
+}
+
+TEST_CASE("mmap_reader - plugs into DataAnalyzer")
+{
+    Ver_1::DataAnalyzer data_analyzer(Statistics::sum, mmap_reader);
+    data_analyzer.load_data("data.dat");
+    data_analyzer.calculate();
+
+    REQUIRE(data_analyzer.results() == Results{{"Sum", 4715.0}});
+}
+
+TEST_CASE("mmap_reader - benchmark", "[.][benchmark]")
+{
+    const std::string file_name = "mmap_reader_benchmark.dat";
+    {
+        std::mt19937_64 rnd_gen{42};
+        std::uniform_real_distribution<double> distr{-1000.0, 1000.0};
+
+        std::ofstream out{file_name};
+        for (int i = 0; i < 1'000'000; ++i)
+            out << distr(rnd_gen) << "\n";
+    }
+
+    BENCHMARK("text_reader")
+    {
+        return Ver_1::text_reader(file_name);
+    };
+
+    BENCHMARK("mmap_reader")
+    {
+        return mmap_reader(file_name);
+    };
+}
@@ -0,0 +1,120 @@
+#include <array>
+#include <catch2/benchmark/catch_benchmark.hpp>
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/matchers/catch_matchers_floating_point.hpp>
+#include <cmath>
+#include <data_analyzer.hpp>
+#include <random>
+#include <streaming_data_analyzer.hpp>
+#include "test_data.hpp"
+
+using namespace std;
+using Catch::Matchers::WithinAbs;
+using Catch::Matchers::WithinRel;
+
+namespace
+{
+    Data make_exponential_data(std::size_t size, double shift)
+    {
+        Data data = make_random_data(size, std::exponential_distribution<double>{1.0});
+        for (double& value : data)
+            value += shift;
+        return data;
+    }
+
+    // two-pass reference in long double
+    std::array<double, 4> reference_moments(const Data& data)
+    {
+        long double n = data.size();
+        long double mean = std::accumulate(data.begin(), data.end(), 0.0L) / n;
+        long double m2 = 0, m3 = 0, m4 = 0;
+        for (long double d : data)
+        {
+            m2 += (d - mean) * (d - mean);
+            m3 += (d - mean) * (d - mean) * (d - mean);
+            m4 += (d - mean) * (d - mean) * (d - mean) * (d - mean);
+        }
+
+        return {static_cast<double>(m2 / n), static_cast<double>(std::sqrt(m2 / n)), static_cast<double>(std::sqrt(n) * m3 / std::pow(m2, 1.5L)),
+            static_cast<double>(n * m4 / (m2 * m2) - 3)};
+    }
+}
+
+TEST_CASE("Moments - known values")
+{
+    Data data = {2, 4, 4, 4, 5, 5, 7, 9};
+
+    REQUIRE(Ver_2::Statistics::variance->calculate(data) == Results{{"Variance", 4.0}});
+    REQUIRE(Ver_2::Statistics::std_dev->calculate(data) == Results{{"StdDev", 2.0}});
+
+    Data symmetric = {1, 2, 3, 4, 5};
+    REQUIRE_THAT(Ver_2::Statistics::skewness->calculate(symmetric)[0].value, WithinAbs(0.0, 1e-15));
+    REQUIRE_THAT(Ver_2::Statistics::kurtosis->calculate(symmetric)[0].value, WithinRel(-1.3, 1e-12));
+}
+
+TEST_CASE("Moments - stable for large offset in fused, streaming and parallel mode")
+{
+    Data data = make_exponential_data(50'003, 1e7);
+    auto expected = reference_moments(data);
+
+    std::vector<std::shared_ptr<Ver_2::IStatistics>> stats = {
+        Ver_2::Statistics::variance, Ver_2::Statistics::std_dev, Ver_2::Statistics::skewness, Ver_2::Statistics::kurtosis};
+
+    auto check = [&](const Results& results) {
+        REQUIRE(results.size() == 4);
+        for (std::size_t i = 0; i < 4; ++i)
+            REQUIRE_THAT(results[i].value, WithinRel(expected[i], 1e-6));
+    };
+
+    SECTION("fused")
+    {
+        check(Ver_2::calculate_fused(stats, data));
+    }
+
+    SECTION("parallel")
+    {
+        check(Ver_2::calculate_parallel(stats, data, 4));
+    }
+
+    SECTION("streaming")
+    {
+        {
+            std::ofstream out{"moments.dat"};
+            out.precision(17);
+            for (double d : data)
+                out << d << "\n";
+        }
+
+        std::vector<std::shared_ptr<Ver_2::IStreamingStatistics>> streaming_stats = {
+            Ver_2::Statistics::variance, Ver_2::Statistics::std_dev, Ver_2::Statistics::skewness, Ver_2::Statistics::kurtosis};
+
+        Ver_2::StreamingDataAnalyzer data_analyzer(Ver_2::Statistics::variance, TextStreamReader{1000});
+        for (const auto& stat : streaming_stats)
+        {
+            data_analyzer.set_statistics(stat);
+            data_analyzer.calculate("moments.dat");
+        }
+
+        check(data_analyzer.results());
+    }
+}
+
+TEST_CASE("Moments - benchmark", "[.][benchmark]")
+{
+    Data data = make_exponential_data(16'000'000, 0.0);
+
+    BENCHMARK("Sum")
+    {
+        return Ver_2::calculate_fused({Ver_2::Statistics::sum}, data);
+    };
+
+    BENCHMARK("Variance")
+    {
+        return Ver_2::calculate_fused({Ver_2::Statistics::variance}, data);
+    };
+
+    BENCHMARK("Kurtosis")
+    {
+        return Ver_2::calculate_fused({Ver_2::Statistics::kurtosis}, data);
+    };
+}
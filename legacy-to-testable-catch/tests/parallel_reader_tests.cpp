@@ -0,0 +1,88 @@
+#include <catch2/benchmark/catch_benchmark.hpp>
+#include <catch2/catch_test_macros.hpp>
+#include <parallel_reader.hpp>
+#include <random>
+
+using namespace std;
+
+TEST_CASE("split_on_separators - chunks end on whitespace")
+{
+    std::string_view text = "123 456\n789 1011\n";
+
+    auto bounds = split_on_separators(text, 3);
+
+    REQUIRE(bounds.front() == 0);
+    REQUIRE(bounds.back() == text.size());
+    for (std::size_t i = 1; i + 1 < bounds.size(); ++i)
+        REQUIRE(is_number_separator(text[bounds[i]]));
+}
+
+TEST_CASE("ParallelReader - reads the same data as text_reader")
+{
+    ParallelReader reader{4, 16};
+
+    REQUIRE(reader("data.dat") == Ver_1::text_reader("data.dat"));
+}
+
+TEST_CASE("ParallelReader - stops at the first token that is not a number")
+{
+    {
+        std::ofstream out{"parallel_reader_garbage.dat"};
+        for (int i = 0; i < 100; ++i)
+            out << i << "\n";
+        out << "abc\n";
+        for (int i = 0; i < 100; ++i)
+            out << i << "\n";
+    }
+
+    ParallelReader reader{8, 16};
+
+    REQUIRE(reader("parallel_reader_garbage.dat") == Ver_1::text_reader("parallel_reader_garbage.dat"));
+}
+
+TEST_CASE("ParallelReader - plugs into DataAnalyzer")
+{
+    SECTION("Ver_1")
+    {
+        Ver_1::DataAnalyzer data_analyzer(Statistics::sum, ParallelReader{4, 16});
+        data_analyzer.load_data("data.dat");
+        data_analyzer.calculate();
+
+        REQUIRE(data_analyzer.results() == Results{{"Sum", 4715.0}});
+    }
+
+    SECTION("Ver_2")
+    {
+        Ver_2::DataAnalyzer data_analyzer(Ver_2::Statistics::sum, parallel_reader);
+        data_analyzer.load_data("data.dat");
+        data_analyzer.calculate();
+
+        REQUIRE(data_analyzer.results() == Results{{"Sum", 4715.0}});
+    }
+}
+
+TEST_CASE("ParallelReader - benchmark", "[.][benchmark]")
+{
+    const std::string file_name = "parallel_reader_benchmark.dat";
+    {
+        std::mt19937_64 rnd_gen{42};
+        std::uniform_real_distribution<double> distr{-1000.0, 1000.0};
+
+        std::ofstream out{file_name};
+        for (int i = 0; i < 4'000'000; ++i)
+            out << distr(rnd_gen) << "\n";
+    }
+
+    BENCHMARK("mmap_reader")
+    {
+        return mmap_reader(file_name);
+    };
+
+    for (std::size_t thread_count : {2, 4, 8, 16})
+    {
+        BENCHMARK("ParallelReader - " + std::to_string(thread_count) + " threads")
+        {
+            return ParallelReader{thread_count}(file_name);
+        };
+    }
+}
@@ -0,0 +1,140 @@
+#include <catch2/benchmark/catch_benchmark.hpp>
+#include <catch2/catch_test_macros.hpp>
+#include <cmath>
+#include <limits>
+#include <numeric>
+#include <percentiles.hpp>
+#include <random>
+#include "test_data.hpp"
+
+using namespace std;
+
+namespace
+{
+    const std::uniform_real_distribution<double> data_distr{-1e9, 1e9};
+}
+
+TEST_CASE("RadixSort - sorts like std::sort")
+{
+    Data data = make_random_data(200'003, data_distr);
+    data.insert(data.end(), {0.0, -0.0, std::numeric_limits<double>::infinity(), -std::numeric_limits<double>::infinity(),
+                                std::numeric_limits<double>::denorm_min(), -std::numeric_limits<double>::max()});
+
+    Data expected = data;
+    std::sort(expected.begin(), expected.end());
+
+    for (std::size_t thread_count : {1, 4})
+    {
+        Data sorted = data;
+        RadixSort::sort(sorted, thread_count);
+
+        REQUIRE(sorted == expected);
+    }
+}
+
+TEST_CASE("RadixSort - keys preserve order of doubles")
+{
+    REQUIRE(RadixSort::to_key(-1.0) < RadixSort::to_key(-0.5));
+    REQUIRE(RadixSort::to_key(-0.0) < RadixSort::to_key(0.0));
+    REQUIRE(RadixSort::to_key(0.0) < RadixSort::to_key(1e-300));
+    REQUIRE(RadixSort::from_key(RadixSort::to_key(-42.5)) == -42.5);
+}
+
+TEST_CASE("Percentiles - nearest rank")
+{
+    Data data = {15, 20, 35, 40, 50};
+
+    Ver_2::Percentiles percentiles{{0.05, 0.3, 0.4, 0.5, 1.0}};
+
+    REQUIRE(percentiles.calculate(data) == Results{{"P5", 15.0}, {"P30", 20.0}, {"P40", 20.0}, {"P50", 35.0}, {"P100", 50.0}});
+}
+
+TEST_CASE("Percentiles - rank is not moved by rounding of q")
+{
+    REQUIRE(0.07 * 100 > 7.0);
+    REQUIRE(Ver_2::Percentiles::rank(0.07, 100) == 6);
+
+    for (std::size_t k = 1; k <= 100; ++k)
+        REQUIRE(Ver_2::Percentiles::rank(static_cast<double>(k) / 100, 100) == k - 1);
+
+    Data data(100);
+    std::iota(data.rbegin(), data.rend(), 1.0);
+    REQUIRE(Ver_2::Percentiles{{0.07}}.calculate(data) == Results{{"P7", 7.0}});
+}
+
+TEST_CASE("Percentiles - strategy")
+{
+    SECTION("is chosen from the number of ranks")
+    {
+        REQUIRE(Ver_2::Percentiles{{0.5, 0.99}}.strategy() == Ver_2::Percentiles::Strategy::selection);
+        REQUIRE(Ver_2::Percentiles{std::vector<double>(100, 0.5)}.strategy() == Ver_2::Percentiles::Strategy::radix_sort);
+    }
+
+    SECTION("selection and radix sort give the same results")
+    {
+        Data data = make_random_data(100'001, data_distr);
+
+        std::vector<double> qs;
+        for (int i = 0; i <= 100; ++i)
+            qs.push_back(i / 100.0);
+
+        Ver_2::Percentiles selection{qs, Ver_2::Percentiles::Strategy::selection};
+        Ver_2::Percentiles radix_sort{qs, Ver_2::Percentiles::Strategy::radix_sort, 4};
+
+        Results results = selection.calculate(data);
+        REQUIRE(results == radix_sort.calculate(data));
+
+        std::sort(data.begin(), data.end());
+        REQUIRE(results[50].value == data[50'000]);
+    }
+
+    SECTION("NaNs are ignored by both strategies")
+    {
+        const double nan = std::numeric_limits<double>::quiet_NaN();
+        Data data = {nan, 40, 15, nan, 50, 20, 35, nan};
+
+        Ver_2::Percentiles selection{{0.05, 0.3, 0.5, 1.0}, Ver_2::Percentiles::Strategy::selection};
+        Ver_2::Percentiles radix_sort{{0.05, 0.3, 0.5, 1.0}, Ver_2::Percentiles::Strategy::radix_sort};
+
+        const Results expected{{"P5", 15.0}, {"P30", 20.0}, {"P50", 35.0}, {"P100", 50.0}};
+        REQUIRE(selection.calculate(data) == expected);
+        REQUIRE(radix_sort.calculate(data) == expected);
+
+        REQUIRE(std::isnan(selection.calculate(Data{nan, nan})[0].value));
+    }
+}
+
+TEST_CASE("Percentiles - plug into DataAnalyzer", "[Integration]")
+{
+    Ver_2::DataAnalyzer data_analyzer(Ver_2::Statistics::percentiles);
+    data_analyzer.load_data("data.dat");
+    data_analyzer.set_statistics({Ver_2::Statistics::min_max, Ver_2::Statistics::percentiles});
+    data_analyzer.calculate();
+
+    REQUIRE(data_analyzer.results().size() == 6);
+    REQUIRE(data_analyzer.results()[5] == StatResult{"P99.9", 99.0});
+}
+
+TEST_CASE("Percentiles - benchmark", "[.][benchmark]")
+{
+    Data data = make_random_data(100'000'000, data_distr);
+
+    BENCHMARK("std::sort")
+    {
+        Data values = data;
+        std::sort(values.begin(), values.end());
+        return values[values.size() / 2];
+    };
+
+    BENCHMARK("RadixSort::sort")
+    {
+        Data values = data;
+        RadixSort::sort(values);
+        return values[values.size() / 2];
+    };
+
+    BENCHMARK("Percentiles - selection of 4 ranks")
+    {
+        return Ver_2::Percentiles{{0.5, 0.9, 0.99, 0.999}, Ver_2::Percentiles::Strategy::selection}.calculate(data);
+    };
+}
@@ -0,0 +1,142 @@
+#include <catch2/benchmark/catch_benchmark.hpp>
+#include <catch2/catch_test_macros.hpp>
+#include <quantiles.hpp>
+#include <random>
+
+using namespace std;
+
+namespace
+{
+    Data make_shuffled_sequence(std::size_t size)
+    {
+        Data data(size);
+        std::iota(data.begin(), data.end(), 0.0);
+        std::shuffle(data.begin(), data.end(), std::mt19937_64{size});
+        return data;
+    }
+
+    // values are 0..size-1, so rank error can be read directly from the value
+    void require_rank_error_below(const Results& results, std::size_t size, double max_rank_error)
+    {
+        const double qs[] = {0.5, 0.9, 0.99, 0.999};
+        REQUIRE(results.size() == std::size(qs));
+        for (std::size_t i = 0; i < std::size(qs); ++i)
+            REQUIRE(std::abs(results[i].value / size - qs[i]) < max_rank_error);
+    }
+}
+
+TEST_CASE("Quantiles - descriptions")
+{
+    REQUIRE(Ver_2::Quantiles::description(0.5) == "P50");
+    REQUIRE(Ver_2::Quantiles::description(0.999) == "P99.9");
+}
+
+TEST_CASE("KllSketch - small input is exact")
+{
+    KllSketch sketch;
+    for (double d : {5.0, 1.0, 3.0, 2.0, 4.0})
+        sketch.update(d);
+
+    REQUIRE(sketch.quantile(0.0) == 1.0);
+    REQUIRE(sketch.quantile(0.5) == 3.0);
+    REQUIRE(sketch.quantile(1.0) == 5.0);
+}
+
+TEST_CASE("KllSketch - memory is bounded")
+{
+    KllSketch sketch;
+    Data data = make_shuffled_sequence(1'000'000);
+    for (double d : data)
+        sketch.update(d);
+
+    REQUIRE(sketch.count() == 1'000'000);
+    REQUIRE(sketch.size() * sizeof(double) < 8 * 1024);
+    REQUIRE(sketch.capacity() * sizeof(double) < 16 * 1024);
+}
+
+TEST_CASE("KllSketch - sketches of different k are not merged")
+{
+    KllSketch sketch{200};
+    KllSketch other{400};
+    other.update(1.0);
+
+    REQUIRE_THROWS_AS(sketch.merge(other), std::invalid_argument);
+
+    SECTION("state of different k is rejected")
+    {
+        StateWriter state{"Kll"};
+        other.serialize(state);
+        const std::string bytes = state.str();
+
+        StateReader reader{bytes, "Kll"};
+        REQUIRE_THROWS_AS(sketch.deserialize(reader), std::runtime_error);
+        REQUIRE(sketch.count() == 0);
+    }
+
+    SECTION("state with count not matching retained values is rejected")
+    {
+        StateWriter state{"Kll"};
+        state.write(std::uint32_t{200});
+        state.write(std::uint64_t{1'000'000}); // count
+        state.write(0.0);
+        state.write(1.0);
+        state.write(std::uint64_t{42});
+        state.write(std::uint64_t{1}); // levels
+        state.write_array(std::vector<double>{0.0, 1.0}.data(), 2);
+        const std::string bytes = state.str();
+
+        StateReader reader{bytes, "Kll"};
+        REQUIRE_THROWS_AS(sketch.deserialize(reader), std::runtime_error);
+    }
+}
+
+TEST_CASE("Quantiles - accuracy in fused, parallel and sharded mode")
+{
+    const std::size_t size = 200'000;
+    Data data = make_shuffled_sequence(size);
+
+    SECTION("fused")
+    {
+        require_rank_error_below(Ver_2::calculate_fused({Ver_2::Statistics::quantiles}, data), size, 0.02);
+    }
+
+    SECTION("parallel")
+    {
+        require_rank_error_below(Ver_2::calculate_parallel({Ver_2::Statistics::quantiles}, data, 4), size, 0.02);
+    }
+
+    SECTION("serialized shards")
+    {
+        std::vector<std::string> states;
+        for (std::size_t offset = 0; offset < size; offset += 50'000)
+        {
+            auto shard = Ver_2::Statistics::quantiles->make_accumulator();
+            shard->update(std::span<const double>{data}.subspan(offset, 50'000));
+            states.push_back(shard->serialize());
+        }
+
+        require_rank_error_below(Ver_2::merge_states(*Ver_2::Statistics::quantiles, states), size, 0.02);
+    }
+
+    SECTION("higher k gives better accuracy")
+    {
+        Ver_2::Quantiles precise_quantiles{{0.5, 0.9, 0.99, 0.999}, 2000};
+
+        require_rank_error_below(precise_quantiles.calculate(data), size, 0.002);
+    }
+}
+
+TEST_CASE("Quantiles - benchmark", "[.][benchmark]")
+{
+    Data data = make_shuffled_sequence(10'000'000);
+
+    BENCHMARK("Sum")
+    {
+        return Ver_2::calculate_fused({Ver_2::Statistics::sum}, data);
+    };
+
+    BENCHMARK("Quantiles")
+    {
+        return Ver_2::calculate_fused({Ver_2::Statistics::quantiles}, data);
+    };
+}
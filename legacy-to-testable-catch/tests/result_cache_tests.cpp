@@ -0,0 +1,186 @@
+#include <catch2/catch_test_macros.hpp>
+#include <filesystem>
+#include <fstream>
+#include <histogram.hpp>
+#include <result_cache.hpp>
+
+using namespace std;
+
+namespace
+{
+    void write_data_file(const std::string& file_name, const std::string& content)
+    {
+        std::ofstream out{file_name};
+        out << content;
+    }
+
+    std::shared_ptr<ResultCache> make_empty_cache(const std::string& directory, std::uint64_t size_limit = ResultCache::default_size_limit)
+    {
+        std::filesystem::remove_all(directory);
+        return std::make_shared<ResultCache>(directory, size_limit);
+    }
+
+    // counts loads of data files
+    struct CountingReader
+    {
+        std::shared_ptr<int> load_count = std::make_shared<int>(0);
+
+        Data operator()(const std::string& file_name) const
+        {
+            ++*load_count;
+            return Ver_2::text_reader(file_name);
+        }
+    };
+}
+
+TEST_CASE("ResultCache - file is not loaded on a hit")
+{
+    write_data_file("cached.dat", "1 2 3 4");
+    auto cache = make_empty_cache("result_cache");
+    CountingReader reader;
+
+    Ver_2::CachedDataAnalyzer data_analyzer({Ver_2::Statistics::sum, Ver_2::Statistics::min_max}, cache, false, reader);
+
+    data_analyzer.calculate("cached.dat");
+    data_analyzer.calculate("cached.dat");
+
+    REQUIRE(*reader.load_count == 1);
+    REQUIRE(data_analyzer.results() == Results{{"Sum", 10}, {"Min", 1}, {"Max", 4}, {"Sum", 10}, {"Min", 1}, {"Max", 4}});
+    REQUIRE(cache->counters().hits == 1);
+    REQUIRE(cache->counters().misses == 1);
+
+    SECTION("changed file is a miss")
+    {
+        write_data_file("cached.dat", "1 2 3 4 5");
+        data_analyzer.clear_results();
+        data_analyzer.calculate("cached.dat");
+
+        REQUIRE(*reader.load_count == 2);
+        REQUIRE(data_analyzer.results()[0] == StatResult{"Sum", 15});
+    }
+
+    SECTION("different statistics are a miss")
+    {
+        data_analyzer.set_statistics({Ver_2::Statistics::sum});
+        data_analyzer.calculate("cached.dat");
+        data_analyzer.set_statistics({std::make_shared<Ver_2::Histogram>(0.0, 10.0, 2)});
+        data_analyzer.calculate("cached.dat");
+        data_analyzer.set_statistics({std::make_shared<Ver_2::Histogram>(0.0, 10.0, 5)});
+        data_analyzer.calculate("cached.dat");
+
+        REQUIRE(*reader.load_count == 4);
+        REQUIRE(cache->entry_count() == 4);
+    }
+
+    SECTION("cache is persistent")
+    {
+        auto reopened_cache = std::make_shared<ResultCache>("result_cache");
+        Ver_2::CachedDataAnalyzer other_analyzer({Ver_2::Statistics::sum, Ver_2::Statistics::min_max}, reopened_cache, false, reader);
+        other_analyzer.calculate("cached.dat");
+
+        REQUIRE(*reader.load_count == 1);
+        REQUIRE(reopened_cache->counters().hits == 1);
+    }
+}
+
+TEST_CASE("ResultCache - content hash detects changes with the same size and time")
+{
+    write_data_file("hashed.dat", "1 2 3");
+    const auto time = std::filesystem::last_write_time("hashed.dat");
+
+    auto cache = make_empty_cache("result_cache_hashed");
+    Ver_2::CachedDataAnalyzer data_analyzer({Ver_2::Statistics::sum}, cache);
+    Ver_2::CachedDataAnalyzer hashing_analyzer({Ver_2::Statistics::sum}, cache, true);
+    data_analyzer.calculate("hashed.dat");
+    hashing_analyzer.calculate("hashed.dat");
+
+    write_data_file("hashed.dat", "4 5 6");
+    std::filesystem::last_write_time("hashed.dat", time);
+
+    data_analyzer.calculate("hashed.dat");
+    hashing_analyzer.calculate("hashed.dat");
+
+    REQUIRE(data_analyzer.results() == Results{{"Sum", 6}, {"Sum", 6}});
+    REQUIRE(hashing_analyzer.results() == Results{{"Sum", 6}, {"Sum", 15}});
+}
+
+TEST_CASE("ResultCache - statistic kinds are stable names")
+{
+    namespace Statistics = Ver_2::Statistics;
+
+    REQUIRE(Statistics::avg->kind() == StateWriter{"Avg"}.str());
+    REQUIRE(Statistics::min_max->kind() == StateWriter{"MinMax"}.str());
+    REQUIRE(Statistics::sum->kind() == StateWriter{"Sum"}.str());
+
+    const std::vector<std::shared_ptr<Ver_2::IStatistics>> statistics{Statistics::avg, Statistics::min_max, Statistics::sum,
+        Statistics::variance, Statistics::std_dev, Statistics::skewness, Statistics::kurtosis, Statistics::top_k, Statistics::bottom_k};
+    for (std::size_t i = 0; i < statistics.size(); ++i)
+        for (std::size_t j = i + 1; j < statistics.size(); ++j)
+            REQUIRE(statistics[i]->kind() != statistics[j]->kind());
+}
+
+TEST_CASE("ResultCache - least recently used entries are evicted")
+{
+    auto cache = make_empty_cache("result_cache_lru");
+    cache->store("a", {{"Sum", 1}});
+    const auto entry_size = cache->size();
+
+    cache = make_empty_cache("result_cache_lru", 3 * entry_size);
+    cache->store("a", {{"Sum", 1}});
+    cache->store("b", {{"Sum", 2}});
+    cache->store("c", {{"Sum", 3}});
+    REQUIRE(cache->find("a").has_value());
+
+    cache->store("d", {{"Sum", 4}});
+
+    REQUIRE(cache->counters().evictions == 1);
+    REQUIRE(cache->entry_count() == 3);
+    REQUIRE(cache->size() <= 3 * entry_size);
+    REQUIRE_FALSE(cache->find("b").has_value());
+    REQUIRE(cache->find("a") == Results{{"Sum", 1}});
+    REQUIRE(cache->find("c") == Results{{"Sum", 3}});
+    REQUIRE(cache->find("d") == Results{{"Sum", 4}});
+
+    SECTION("damaged entry is a miss")
+    {
+        for (const auto& file : std::filesystem::directory_iterator{"result_cache_lru"})
+            std::ofstream{file.path()} << "damaged";
+
+        REQUIRE_FALSE(cache->find("a").has_value());
+        REQUIRE(cache->entry_count() == 2);
+    }
+}
+
+TEST_CASE("ResultCache - caches sharing a directory share its size limit")
+{
+    auto cache = make_empty_cache("result_cache_shared");
+    cache->store("a", {{"Sum", 1}});
+    const auto entry_size = cache->size();
+
+    cache = make_empty_cache("result_cache_shared", 3 * entry_size);
+    auto other_cache = std::make_shared<ResultCache>("result_cache_shared", 3 * entry_size);
+
+    cache->store("a", {{"Sum", 1}});
+    cache->store("b", {{"Sum", 2}});
+    other_cache->store("c", {{"Sum", 3}});
+    other_cache->store("d", {{"Sum", 4}});
+    other_cache->store("e", {{"Sum", 5}});
+    REQUIRE(other_cache->counters().evictions == 0); // directory is scanned only when its own entries exceed the limit
+
+    other_cache->store("f", {{"Sum", 6}});
+
+    REQUIRE(other_cache->counters().evictions == 3);
+    REQUIRE(other_cache->entry_count() == 3);
+    REQUIRE_FALSE(other_cache->find("a").has_value());
+    REQUIRE_FALSE(other_cache->find("c").has_value());
+    REQUIRE(other_cache->find("d") == Results{{"Sum", 4}});
+    REQUIRE_FALSE(cache->find("a").has_value());
+
+    std::size_t file_count = 0;
+    for (const auto& file : std::filesystem::directory_iterator{"result_cache_shared"})
+    {
+        REQUIRE(file.path().extension() == ".result");
+        ++file_count;
+    }
+    REQUIRE(file_count == 3);
+}
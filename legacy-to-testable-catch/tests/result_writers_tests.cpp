@@ -0,0 +1,148 @@
+#include <catch2/benchmark/catch_benchmark.hpp>
+#include <catch2/catch_test_macros.hpp>
+#include <charconv>
+#include <cmath>
+#include <cstring>
+#include <fstream>
+#include <histogram.hpp>
+#include <iterator>
+#include <limits>
+#include <random>
+#include <result_writers.hpp>
+
+using namespace std;
+
+namespace
+{
+    std::string file_content(const std::string& file_name)
+    {
+        std::ifstream in{file_name, std::ios::binary};
+        return {std::istreambuf_iterator<char>{in}, std::istreambuf_iterator<char>{}};
+    }
+
+    const Results special_results{{"Avg", 47.15}, {"Bin[0, 10)", 3.0}, {"Min", -0.0}, {"NaN", std::numeric_limits<double>::quiet_NaN()},
+        {"Inf", std::numeric_limits<double>::infinity()}, {"Tiny", 1e-300}};
+}
+
+TEST_CASE("csv_writer")
+{
+    SECTION("header and one line per result")
+    {
+        csv_writer("results.csv", Results{{"Avg", 47.15}, {"Sum", 4715.0}, {"Min", -3.0}});
+
+        REQUIRE(file_content("results.csv") == "description,value\nAvg,47.15\nSum,4715\nMin,-3\n");
+    }
+
+    SECTION("descriptions with separators and quotes are quoted")
+    {
+        csv_writer("results.csv", Results{{"Bin[0, 10)", 1.0}, {"Say \"hi\"", 2.0}});
+
+        REQUIRE(file_content("results.csv") == "description,value\n\"Bin[0, 10)\",1\n\"Say \"\"hi\"\"\",2\n");
+    }
+
+    SECTION("values read back exactly")
+    {
+        Results results;
+        std::mt19937_64 rnd_gen{42};
+        std::uniform_real_distribution<double> distr{-1e6, 1e6};
+        for (int i = 0; i < 1000; ++i)
+            results.push_back(StatResult("Value", distr(rnd_gen)));
+
+        csv_writer("results.csv", results);
+
+        std::ifstream in{"results.csv"};
+        std::string line;
+        std::getline(in, line);
+        for (const auto& result : results)
+        {
+            std::getline(in, line);
+            double value;
+            const auto comma = line.find(',');
+            std::from_chars(line.data() + comma + 1, line.data() + line.size(), value);
+            REQUIRE(value == result.value);
+        }
+    }
+}
+
+TEST_CASE("json_lines_writer")
+{
+    SECTION("one object per line")
+    {
+        json_lines_writer("results.jsonl", Results{{"Avg", 47.15}, {"Sum", 4715.0}});
+
+        REQUIRE(file_content("results.jsonl") == "{\"description\":\"Avg\",\"value\":47.15}\n{\"description\":\"Sum\",\"value\":4715}\n");
+    }
+
+    SECTION("strings are escaped and special values are null")
+    {
+        json_lines_writer("results.jsonl", Results{{"a\"b\\c\nd\x01", std::numeric_limits<double>::quiet_NaN()}, {"Inf", -std::numeric_limits<double>::infinity()}});
+
+        REQUIRE(file_content("results.jsonl") == "{\"description\":\"a\\\"b\\\\c\\nd\\u0001\",\"value\":null}\n{\"description\":\"Inf\",\"value\":null}\n");
+    }
+}
+
+TEST_CASE("binary_results_writer - round trip")
+{
+    binary_results_writer("results.bin", special_results);
+
+    Results results = binary_results_reader("results.bin");
+
+    REQUIRE(results.size() == special_results.size());
+    for (std::size_t i = 0; i < results.size(); ++i)
+    {
+        REQUIRE(results[i].description == special_results[i].description);
+        REQUIRE(std::memcmp(&results[i].value, &special_results[i].value, sizeof(double)) == 0);
+    }
+
+    binary_results_writer("results.bin", Results{});
+    REQUIRE(binary_results_reader("results.bin").empty());
+
+    REQUIRE_THROWS_AS(binary_results_reader("data.dat"), std::runtime_error);
+}
+
+TEST_CASE("result writers - plug into DataAnalyzer")
+{
+    Ver_2::DataAnalyzer data_analyzer(Ver_2::Statistics::sum, Ver_2::text_reader, csv_writer);
+    data_analyzer.load_data("data.dat");
+    data_analyzer.calculate();
+    data_analyzer.save_results("results.csv");
+
+    REQUIRE(file_content("results.csv") == "description,value\nSum,4715\n");
+}
+
+TEST_CASE("result writers - file not opened")
+{
+    REQUIRE_THROWS_AS(csv_writer("no_such_directory/results.csv", special_results), std::runtime_error);
+    REQUIRE_THROWS_AS(json_lines_writer("no_such_directory/results.jsonl", special_results), std::runtime_error);
+    REQUIRE_THROWS_AS(binary_results_writer("no_such_directory/results.bin", special_results), std::runtime_error);
+}
+
+TEST_CASE("result writers - benchmark", "[.][benchmark]")
+{
+    Data data(1'000'000);
+    std::mt19937_64 rnd_gen{42};
+    std::uniform_real_distribution<double> distr{0.0, 1'000'000.0};
+    std::generate(data.begin(), data.end(), [&] { return distr(rnd_gen); });
+
+    const Results results = Ver_2::Histogram{0.0, 1'000'000.0, 1'000'000}.calculate(data);
+
+    BENCHMARK("text_writer")
+    {
+        Ver_2::text_writer("benchmark_results.txt", results);
+    };
+
+    BENCHMARK("csv_writer")
+    {
+        csv_writer("benchmark_results.csv", results);
+    };
+
+    BENCHMARK("json_lines_writer")
+    {
+        json_lines_writer("benchmark_results.jsonl", results);
+    };
+
+    BENCHMARK("binary_results_writer")
+    {
+        binary_results_writer("benchmark_results.bin", results);
+    };
+}
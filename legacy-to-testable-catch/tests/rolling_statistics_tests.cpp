@@ -0,0 +1,159 @@
+#include <catch2/benchmark/catch_benchmark.hpp>
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/matchers/catch_matchers_floating_point.hpp>
+#include <cmath>
+#include <fstream>
+#include <limits>
+#include <random>
+#include <rolling_statistics.hpp>
+#include "test_data.hpp"
+
+using namespace std;
+using Catch::Matchers::WithinRel;
+
+namespace
+{
+    const std::normal_distribution<double> data_distr{1e6, 100.0};
+
+    std::vector<Ver_2::RollingValues> rolling(std::size_t window_size, const Data& data, std::size_t chunk_size)
+    {
+        Ver_2::RollingStatistics rolling_statistics{window_size};
+        std::vector<Ver_2::RollingValues> rows;
+
+        std::span<const double> values{data};
+        for (std::size_t offset = 0; offset < values.size(); offset += chunk_size)
+        {
+            rolling_statistics.update(values.subspan(offset, std::min(chunk_size, values.size() - offset)),
+                [&](std::span<const Ver_2::RollingValues> batch) { rows.insert(rows.end(), batch.begin(), batch.end()); });
+        }
+
+        return rows;
+    }
+}
+
+TEST_CASE("RollingStatistics - window of 3 samples")
+{
+    Data data = {1, 3, 2, 5, 4, 0};
+
+    auto rows = rolling(3, data, 2);
+
+    REQUIRE(rows == std::vector<Ver_2::RollingValues>{{2, 6, 2, 1, 3}, {3, 10, 10.0 / 3, 2, 5}, {4, 11, 11.0 / 3, 2, 5}, {5, 9, 3, 0, 5}});
+}
+
+TEST_CASE("RollingStatistics - NaN samples")
+{
+    Data data = {1, std::nan(""), 2, 3, 4};
+
+    auto rows = rolling(2, data, 100);
+
+    REQUIRE(rows.size() == 4);
+    REQUIRE(std::isnan(rows[0].sum));
+    REQUIRE(rows[0].min == 1.0);
+    REQUIRE(rows[0].max == 1.0);
+    REQUIRE(std::isnan(rows[1].mean));
+    REQUIRE(rows[2] == Ver_2::RollingValues{3, 5, 2.5, 2, 3});
+}
+
+TEST_CASE("RollingStatistics - infinite samples")
+{
+    const double inf = std::numeric_limits<double>::infinity();
+    Data data = {1, inf, 2, -inf, 3, 4, 5};
+
+    auto rows = rolling(2, data, 100);
+
+    REQUIRE(rows.size() == 6);
+    REQUIRE(rows[0] == Ver_2::RollingValues{1, inf, inf, 1, inf});
+    REQUIRE(rows[1] == Ver_2::RollingValues{2, inf, inf, 2, inf});
+    REQUIRE(rows[2] == Ver_2::RollingValues{3, -inf, -inf, -inf, 2});
+    REQUIRE(rows[3] == Ver_2::RollingValues{4, -inf, -inf, -inf, 3});
+    REQUIRE(rows[4] == Ver_2::RollingValues{5, 7, 3.5, 3, 4});
+    REQUIRE(rows[5] == Ver_2::RollingValues{6, 9, 4.5, 4, 5});
+
+    SECTION("both signs in the window give NaN")
+    {
+        auto rows = rolling(3, data, 100);
+
+        REQUIRE(std::isnan(rows[1].sum));
+        REQUIRE(rows[4] == Ver_2::RollingValues{6, 12, 4, 3, 5});
+    }
+}
+
+TEST_CASE("RollingStatistics - matches brute force for any chunking")
+{
+    Data data = make_random_data(10'007, data_distr);
+
+    for (std::size_t window_size : {1, 10, 1000})
+    {
+        auto rows = rolling(window_size, data, 333);
+        REQUIRE(rows == rolling(window_size, data, 10'007));
+        REQUIRE(rows.size() == data.size() - window_size + 1);
+
+        for (std::size_t i = 0; i < rows.size(); i += 97)
+        {
+            INFO("window size: " << window_size << ", row: " << i);
+
+            auto first = data.begin() + i;
+            auto last = first + window_size;
+            REQUIRE(rows[i].index == i + window_size - 1);
+            REQUIRE(rows[i].min == *std::min_element(first, last));
+            REQUIRE(rows[i].max == *std::max_element(first, last));
+            REQUIRE_THAT(rows[i].sum, WithinRel(std::accumulate(first, last, 0.0L), 1e-14));
+        }
+    }
+
+    REQUIRE_THROWS_AS(Ver_2::RollingStatistics{0}, std::invalid_argument);
+}
+
+TEST_CASE("RollingStatistics - series is written to file", "[Integration]")
+{
+    Ver_2::rolling_statistics("data.dat", "rolling.csv", 10);
+
+    std::ifstream fin{"rolling.csv"};
+    std::string header, first_row;
+    std::getline(fin, header);
+    std::getline(fin, first_row);
+
+    REQUIRE(header == "Index,Sum,Mean,Min,Max");
+    REQUIRE(first_row.starts_with("9,"));
+
+    std::size_t row_count = 2;
+    for (std::string line; std::getline(fin, line);)
+        ++row_count;
+    REQUIRE(row_count == Ver_2::text_reader("data.dat").size() - 9 + 1);
+
+#ifdef __linux__
+    SECTION("write error is reported")
+    {
+        REQUIRE_THROWS_AS(Ver_2::rolling_statistics("data.dat", "/dev/full", 10), std::runtime_error);
+    }
+#endif
+}
+
+TEST_CASE("RollingStatistics - benchmark", "[.][benchmark]")
+{
+    Data data = make_random_data(10'000'000, data_distr);
+
+    BENCHMARK("Sum")
+    {
+        return Ver_2::calculate_fused({Ver_2::Statistics::sum}, data);
+    };
+
+    for (std::size_t window_size : {16, 1024, 65536})
+    {
+        BENCHMARK("RollingStatistics - window " + std::to_string(window_size))
+        {
+            Ver_2::RollingStatistics rolling_statistics{window_size};
+            double checksum = 0.0;
+            rolling_statistics.update(data, [&](std::span<const Ver_2::RollingValues> rows) { checksum += rows.back().max; });
+            return checksum;
+        };
+    }
+
+    BENCHMARK("RollingSeriesWriter - 1M rows")
+    {
+        Ver_2::RollingStatistics rolling_statistics{1024};
+        Ver_2::RollingSeriesWriter writer{"rolling_benchmark.csv"};
+        rolling_statistics.update(std::span<const double>{data}.first(1'000'000),
+            [&](std::span<const Ver_2::RollingValues> rows) { writer.write(rows); });
+    };
+}
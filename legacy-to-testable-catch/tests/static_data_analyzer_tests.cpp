@@ -0,0 +1,105 @@
+#include <bit>
+#include <catch2/benchmark/catch_benchmark.hpp>
+#include <catch2/catch_test_macros.hpp>
+#include <random>
+#include <static_data_analyzer.hpp>
+#include "test_data.hpp"
+
+using namespace std;
+
+namespace
+{
+    const std::uniform_real_distribution<double> data_distr{-1000.0, 1000.0};
+}
+
+TEST_CASE("StaticDataAnalyzer - calculate stats", "[Integration]")
+{
+    Ver_2::StaticDataAnalyzer<Ver_2::Avg, Ver_2::MinMax, Ver_2::Sum> data_analyzer;
+    data_analyzer.load_data("data.dat");
+    data_analyzer.calculate();
+
+    REQUIRE(data_analyzer.values() == std::array{47.15, 1.0, 99.0, 4715.0});
+    REQUIRE(data_analyzer.results() == Results{{"Avg", 47.15}, {"Min", 1.0}, {"Max", 99.0}, {"Sum", 4715.0}});
+}
+
+TEST_CASE("StaticDataAnalyzer - results are bit-identical to calculate_fused")
+{
+    const std::vector<std::shared_ptr<Ver_2::IStatistics>> stats = {Ver_2::Statistics::avg, Ver_2::Statistics::min_max, Ver_2::Statistics::sum};
+
+    for (std::size_t size : std::initializer_list<std::size_t>{1, 15, 16, 17, 10'001, 3 * Ver_2::fused_block_size + 5})
+    {
+        INFO("size: " << size);
+
+        Data data = make_random_data(size, data_distr);
+
+        auto [avg, min, max, sum] = Ver_2::StaticDataAnalyzer<Ver_2::Avg, Ver_2::MinMax, Ver_2::Sum>::calculate(data);
+        Results results = Ver_2::calculate_fused(stats, data);
+
+        REQUIRE(std::bit_cast<std::uint64_t>(avg) == std::bit_cast<std::uint64_t>(results[0].value));
+        REQUIRE(min == results[1].value);
+        REQUIRE(max == results[2].value);
+        REQUIRE(std::bit_cast<std::uint64_t>(sum) == std::bit_cast<std::uint64_t>(results[3].value));
+    }
+
+    SECTION("within a block results are those of kernels")
+    {
+        Data data = make_random_data(Ver_2::fused_block_size, data_distr);
+
+        auto [sum, min, max] = Ver_2::StaticDataAnalyzer<Ver_2::Sum, Ver_2::MinMax>::calculate(data);
+
+        REQUIRE(std::bit_cast<std::uint64_t>(sum) == std::bit_cast<std::uint64_t>(Kernels::sum(data)));
+        REQUIRE(min == Kernels::min_max(data).min);
+        REQUIRE(max == Kernels::min_max(data).max);
+    }
+}
+
+TEST_CASE("StaticDataAnalyzer - Avg and Sum share their state")
+{
+    using Analyzer = Ver_2::StaticDataAnalyzer<Ver_2::Avg, Ver_2::MinMax, Ver_2::Sum>;
+
+    static_assert(std::tuple_size_v<Analyzer::States> == 2);
+
+    REQUIRE(Analyzer::calculate(Data{3, 1, 2}) == std::array{2.0, 1.0, 3.0, 6.0});
+}
+
+TEST_CASE("StaticDataAnalyzer - order of results follows order of statistics")
+{
+    using Analyzer = Ver_2::StaticDataAnalyzer<Ver_2::Sum, Ver_2::MinMax>;
+
+    static_assert(Analyzer::result_count == 3);
+    static_assert(Analyzer::descriptions == std::array<std::string_view, 3>{"Sum", "Min", "Max"});
+
+    REQUIRE(Analyzer::calculate(Data{3, 1, 2}) == std::array{6.0, 1.0, 3.0});
+}
+
+TEST_CASE("StaticDataAnalyzer - benchmark", "[.][benchmark]")
+{
+    std::vector<std::shared_ptr<Ver_2::IStatistics>> stats = {Ver_2::Statistics::avg, Ver_2::Statistics::min_max, Ver_2::Statistics::sum};
+
+    for (std::size_t size : {16, 1'000, 1'000'000})
+    {
+        Data data = make_random_data(size, data_distr);
+        const std::string suffix = " - " + std::to_string(size);
+
+        BENCHMARK("IStatistics::calculate" + suffix)
+        {
+            Results results;
+            for (const auto& stat : stats)
+            {
+                Results current_results = stat->calculate(data);
+                results.insert(results.end(), current_results.begin(), current_results.end());
+            }
+            return results;
+        };
+
+        BENCHMARK("calculate_fused" + suffix)
+        {
+            return Ver_2::calculate_fused(stats, data);
+        };
+
+        BENCHMARK("StaticDataAnalyzer<Avg, MinMax, Sum>" + suffix)
+        {
+            return Ver_2::StaticDataAnalyzer<Ver_2::Avg, Ver_2::MinMax, Ver_2::Sum>::calculate(data);
+        };
+    }
+}
@@ -0,0 +1,64 @@
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/generators/catch_generators.hpp>
+#include <streaming_data_analyzer.hpp>
+
+using namespace std;
+
+TEST_CASE("TextStreamReader - chunks contain the same data as text_reader")
+{
+    auto block_size = GENERATE(values<std::size_t>({1, 7, 4096}));
+    auto chunk_size = GENERATE(values<std::size_t>({1, 3, 1000}));
+
+    TextStreamReader reader{chunk_size, block_size};
+
+    Data data;
+    reader("data.dat", [&](std::span<const double> chunk) {
+        REQUIRE(chunk.size() > 0);
+        REQUIRE(chunk.size() <= chunk_size);
+        data.insert(data.end(), chunk.begin(), chunk.end());
+    });
+
+    REQUIRE(data == Ver_2::text_reader("data.dat"));
+}
+
+TEST_CASE("Accumulators - chunked updates give the same results as calculate")
+{
+    Data data = {5, -1, 3, 8, 2, 7};
+    std::span<const double> values{data};
+
+    std::vector<std::shared_ptr<Ver_2::IStreamingStatistics>> stats = {Ver_2::Statistics::avg, Ver_2::Statistics::min_max, Ver_2::Statistics::sum};
+
+    for (const auto& stat : stats)
+    {
+        auto accumulator = stat->make_accumulator();
+        accumulator->update(values.first(2));
+        accumulator->update(values.subspan(2, 0));
+        accumulator->update(values.subspan(2));
+
+        REQUIRE(accumulator->finalize() == stat->calculate(data));
+    }
+}
+
+TEST_CASE("Accumulators - init resets state")
+{
+    Data data = {1, 2, 3};
+
+    Ver_2::MinMax::Accumulator accumulator;
+    accumulator.update(Data{-100, 100});
+    accumulator.init();
+    accumulator.update(data);
+
+    REQUIRE(accumulator.finalize() == Results{{"Min", 1.0}, {"Max", 3.0}});
+}
+
+TEST_CASE("StreamingDataAnalyzer - calculate stats")
+{
+    Ver_2::StreamingDataAnalyzer data_analyzer(Ver_2::Statistics::avg, TextStreamReader{16, 64});
+    data_analyzer.calculate("data.dat");
+    data_analyzer.set_statistics(Ver_2::Statistics::min_max);
+    data_analyzer.calculate("data.dat");
+    data_analyzer.set_statistics(Ver_2::Statistics::sum);
+    data_analyzer.calculate("data.dat");
+
+    REQUIRE(data_analyzer.results() == Results{{"Avg", 47.15}, {"Min", 1.0}, {"Max", 99.0}, {"Sum", 4715.0}});
+}
@@ -0,0 +1,27 @@
+#ifndef TEST_DATA_HPP
+#define TEST_DATA_HPP
+
+#include <algorithm>
+#include <cstdint>
+#include <random>
+#include <vector>
+
+// size values drawn from distr - the generator is seeded with seed, so data is the same in every run
+template <typename Distribution>
+std::vector<double> make_random_data(std::size_t size, Distribution distr, std::uint64_t seed)
+{
+    std::mt19937_64 rnd_gen{seed};
+
+    std::vector<double> data(size);
+    std::generate(data.begin(), data.end(), [&] { return distr(rnd_gen); });
+    return data;
+}
+
+// seeded with size - data of different sizes differs
+template <typename Distribution>
+std::vector<double> make_random_data(std::size_t size, Distribution distr)
+{
+    return make_random_data(size, distr, size);
+}
+
+#endif // TEST_DATA_HPP
@@ -0,0 +1,121 @@
+#include <catch2/benchmark/catch_benchmark.hpp>
+#include <catch2/catch_test_macros.hpp>
+#include <cmath>
+#include <data_analyzer.hpp>
+#include <random>
+#include "test_data.hpp"
+
+using namespace std;
+
+namespace
+{
+    const std::uniform_real_distribution<double> data_distr{-1e9, 1e9};
+
+    Data sorted_values(const Results& results)
+    {
+        Data values;
+        for (const auto& result : results)
+            values.push_back(result.value);
+        return values;
+    }
+}
+
+TEST_CASE("TopK - largest and smallest values in order")
+{
+    Data data = {5, 1, 9, std::nan(""), 3, 9, -2, 7};
+
+    REQUIRE(Ver_2::TopK{3}.calculate(data) == Results{{"Top1", 9.0}, {"Top2", 9.0}, {"Top3", 7.0}});
+    REQUIRE(Ver_2::TopK{2, Ver_2::TopK::Order::smallest}.calculate(data) == Results{{"Bottom1", -2.0}, {"Bottom2", 1.0}});
+}
+
+TEST_CASE("TopK - fewer values than K")
+{
+    Data data = {2, 1};
+
+    REQUIRE(Ver_2::Statistics::top_k->calculate(data) == Results{{"Top1", 2.0}, {"Top2", 1.0}});
+    REQUIRE(Ver_2::Statistics::bottom_k->calculate(Data{}).empty());
+    REQUIRE_THROWS_AS(Ver_2::TopK{0}, std::invalid_argument);
+}
+
+TEST_CASE("TopK - matches sorted data")
+{
+    Data data = make_random_data(1'000'003, data_distr);
+    Data sorted = data;
+    std::sort(sorted.begin(), sorted.end());
+
+    for (std::size_t k : {1, 100, 100'000})
+    {
+        INFO("K: " << k);
+
+        Data largest = sorted_values(Ver_2::TopK{k}.calculate(data));
+        REQUIRE(largest == Data(sorted.rbegin(), sorted.rbegin() + k));
+
+        Data smallest = sorted_values(Ver_2::TopK{k, Ver_2::TopK::Order::smallest}.calculate(data));
+        REQUIRE(smallest == Data(sorted.begin(), sorted.begin() + k));
+    }
+
+    SECTION("ascending data - every value is a new candidate")
+    {
+        REQUIRE(sorted_values(Ver_2::TopK{1000}.calculate(sorted)) == Data(sorted.rbegin(), sorted.rbegin() + 1000));
+    }
+}
+
+TEST_CASE("TopK - parallel and sharded results are the same as fused")
+{
+    Data data = make_random_data(200'000, data_distr);
+    std::vector<std::shared_ptr<Ver_2::IStatistics>> stats = {Ver_2::Statistics::top_k, Ver_2::Statistics::bottom_k};
+    auto expected = Ver_2::calculate_fused(stats, data);
+    REQUIRE(expected.size() == 200);
+
+    SECTION("parallel")
+    {
+        REQUIRE(Ver_2::calculate_parallel(stats, data, 4) == expected);
+    }
+
+    SECTION("serialized shards")
+    {
+        std::vector<std::string> states;
+        for (std::size_t offset = 0; offset < data.size(); offset += 50'000)
+        {
+            auto shard = Ver_2::Statistics::top_k->make_accumulator();
+            shard->update(std::span<const double>{data}.subspan(offset, 50'000));
+            states.push_back(shard->serialize());
+        }
+
+        REQUIRE(Ver_2::merge_states(*Ver_2::Statistics::top_k, states) == Results(expected.begin(), expected.begin() + 100));
+    }
+
+    SECTION("parameters must match")
+    {
+        auto accumulator = Ver_2::Statistics::top_k->make_accumulator();
+
+        REQUIRE_THROWS_AS(accumulator->merge(*Ver_2::Statistics::bottom_k->make_accumulator()), std::invalid_argument);
+    }
+}
+
+TEST_CASE("TopK - benchmark", "[.][benchmark]")
+{
+    Data data = make_random_data(50'000'000, data_distr);
+
+    BENCHMARK("MinMax")
+    {
+        return Ver_2::calculate_fused({Ver_2::Statistics::min_max}, data);
+    };
+
+    BENCHMARK("TopK - 100")
+    {
+        return Ver_2::calculate_fused({Ver_2::Statistics::top_k}, data);
+    };
+
+    BENCHMARK("TopK - 100'000")
+    {
+        return Ver_2::TopK{100'000}.calculate(data);
+    };
+
+    BENCHMARK("std::partial_sort_copy - 100'000")
+    {
+        Data top(100'000);
+        std::partial_sort_copy(data.begin(), data.end(), top.begin(), top.end(), std::greater<>{});
+        return top;
+    };
+}
@@ -0,0 +1,44 @@
+#include <atomic>
+#include <catch2/catch_test_macros.hpp>
+#include <stdexcept>
+#include <work_stealing_pool.hpp>
+
+using namespace std;
+
+TEST_CASE("WorkStealingPool - runs all tasks")
+{
+    std::atomic<int> count = 0;
+
+    WorkStealingPool pool{4};
+    for (int i = 0; i < 1000; ++i)
+        pool.submit([&] { ++count; });
+    pool.wait();
+
+    REQUIRE(count == 1000);
+}
+
+TEST_CASE("WorkStealingPool - tasks can submit tasks")
+{
+    std::atomic<int> count = 0;
+
+    WorkStealingPool pool{3};
+    for (int i = 0; i < 10; ++i)
+        pool.submit([&] {
+            for (int j = 0; j < 10; ++j)
+                pool.submit([&] { ++count; });
+        });
+    pool.wait();
+
+    REQUIRE(count == 100);
+}
+
+TEST_CASE("WorkStealingPool - exception is rethrown by wait")
+{
+    WorkStealingPool pool{2};
+    pool.submit([] { throw std::runtime_error("Error!!!"); });
+
+    REQUIRE_THROWS_AS(pool.wait(), std::runtime_error);
+
+    pool.submit([] {});
+    REQUIRE_NOTHROW(pool.wait());
+}
@@ -0,0 +1,221 @@
+#include <binary_format.hpp>
+#include <catch2/benchmark/catch_benchmark.hpp>
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/matchers/catch_matchers_floating_point.hpp>
+#include <chrono>
+#include <cmath>
+#include <data_analyzer.hpp>
+#include <filesystem>
+#include <random>
+#include <zone_map.hpp>
+#include "test_data.hpp"
+
+using namespace std;
+using Catch::Matchers::WithinRel;
+
+namespace
+{
+    const std::uniform_real_distribution<double> data_distr{-1e6, 1e6};
+
+    void require_same_summary(const ZoneSummary& summary, const Data& data, std::size_t begin, std::size_t end)
+    {
+        INFO("range: [" << begin << ", " << end << ")");
+
+        REQUIRE(summary.count == end - begin);
+        if (begin == end)
+        {
+            REQUIRE(std::isnan(summary.min));
+            return;
+        }
+
+        REQUIRE(summary.min == *std::min_element(data.begin() + begin, data.begin() + end));
+        REQUIRE(summary.max == *std::max_element(data.begin() + begin, data.begin() + end));
+        REQUIRE_THAT(summary.sum, WithinRel(static_cast<double>(std::accumulate(data.begin() + begin, data.begin() + end, 0.0L)), 1e-9));
+    }
+}
+
+TEST_CASE("ZoneMap - range queries match full scan")
+{
+    Data data = make_random_data(10'007, data_distr);
+    ZoneMap zone_map = ZoneMap::build(data, 100);
+
+    REQUIRE(zone_map.blocks().size() == 101);
+    REQUIRE(zone_map.blocks().back().count == 7);
+
+    const std::pair<std::size_t, std::size_t> ranges[] = {
+        {0, 0}, {0, 10'007}, {5, 50}, {50, 150}, {100, 200}, {99, 201}, {0, 100}, {10'000, 10'007}, {1234, 9876}};
+    for (auto [begin, end] : ranges)
+        require_same_summary(zone_map.query(data, begin, end), data, begin, end);
+
+    REQUIRE_THROWS_AS(zone_map.query(data, 10, 5), std::out_of_range);
+    REQUIRE_THROWS_AS(zone_map.query(data, 0, 10'008), std::out_of_range);
+    REQUIRE_THROWS_AS(zone_map.query(Data(10), 0, 1), std::invalid_argument);
+}
+
+TEST_CASE("ZoneMap - sidecar file")
+{
+    Data data = make_random_data(300'000, data_distr);
+    binary_writer("zone_map.bin", data);
+    ZoneMap zone_map = ZoneMap::build(data, ZoneMap::default_block_size, ZoneMap::source_of("zone_map.bin"));
+    zone_map.save(ZoneMap::sidecar_name("zone_map.bin"));
+
+    ZoneMap loaded = ZoneMap::load("zone_map.bin.zonemap");
+
+    REQUIRE(loaded.block_size() == ZoneMap::default_block_size);
+    REQUIRE(loaded.count() == data.size());
+    REQUIRE(loaded.query(data, 1000, 250'000).sum == zone_map.query(data, 1000, 250'000).sum);
+    REQUIRE(loaded.source() == zone_map.source());
+    REQUIRE(loaded.matches("zone_map.bin"));
+    REQUIRE_FALSE(loaded.matches("data.dat"));
+    REQUIRE_FALSE(loaded.matches("zone_map_missing.bin"));
+    REQUIRE_FALSE(ZoneMap::build(data).matches("zone_map.bin"));
+
+    SECTION("range queries read only edge blocks of the mapped file")
+    {
+        BinaryFormat::BinaryFile file{"zone_map.bin"};
+
+        const std::pair<std::size_t, std::size_t> ranges[] = {{0, 0}, {0, 300'000}, {5, 50}, {65'530, 65'540}, {1000, 250'000}};
+        for (auto [begin, end] : ranges)
+            require_same_summary(loaded.query(file, begin, end), data, begin, end);
+
+        REQUIRE_THROWS_AS(loaded.query(file, 0, 300'001), std::out_of_range);
+    }
+
+    SECTION("index of rewritten file is rejected")
+    {
+        std::filesystem::last_write_time("zone_map.bin", std::filesystem::last_write_time("zone_map.bin") + std::chrono::seconds{1});
+
+        REQUIRE_FALSE(loaded.matches("zone_map.bin"));
+    }
+
+    {
+        std::ofstream out{"zone_map_corrupted.dat", std::ios::binary};
+        out << "TDZM";
+    }
+    REQUIRE_THROWS_AS(ZoneMap::load("zone_map_corrupted.dat"), std::runtime_error);
+
+    {
+        // consistent header of 2^61 one-value blocks without any summaries
+        const std::uint32_t version = 3, block_size = 1;
+        const std::uint64_t count = std::uint64_t{1} << 61, block_count = count;
+        const ZoneMapSource source{};
+        std::ofstream out{"zone_map_crafted.dat", std::ios::binary};
+        out << "TDZM";
+        out.write(reinterpret_cast<const char*>(&version), sizeof(version));
+        out.write(reinterpret_cast<const char*>(&block_size), sizeof(block_size));
+        out.write(reinterpret_cast<const char*>(&count), sizeof(count));
+        out.write(reinterpret_cast<const char*>(&block_count), sizeof(block_count));
+        out.write(reinterpret_cast<const char*>(&source), sizeof(source));
+    }
+    REQUIRE_THROWS_AS(ZoneMap::load("zone_map_crafted.dat"), std::runtime_error);
+}
+
+TEST_CASE("ZoneMap - built by DataAnalyzer", "[Integration]")
+{
+    Ver_2::DataAnalyzer data_analyzer(Ver_2::Statistics::sum);
+    data_analyzer.load_data("data.dat");
+
+    auto without_zone_map = data_analyzer.range_summary(3, 17);
+
+    data_analyzer.build_zone_map(4);
+    REQUIRE(data_analyzer.has_zone_map());
+    data_analyzer.calculate_range(3, 17);
+
+    const auto& results = data_analyzer.results();
+    REQUIRE(results.size() == 4);
+    REQUIRE(results[0] == StatResult{"Count", 14.0});
+    REQUIRE(results[1].value == without_zone_map.sum);
+    REQUIRE(results[2].value == without_zone_map.min);
+    REQUIRE(results[3].value == without_zone_map.max);
+
+    data_analyzer.save_zone_map("data.dat.zonemap");
+    data_analyzer.load_data("data.dat");
+    REQUIRE_FALSE(data_analyzer.has_zone_map());
+    data_analyzer.load_zone_map("data.dat");
+    REQUIRE(data_analyzer.has_zone_map());
+    REQUIRE(data_analyzer.range_summary(3, 17).sum == without_zone_map.sum);
+
+    SECTION("index of another file is rejected")
+    {
+        Data edited = Ver_2::text_reader("data.dat");
+        edited[50] += 1.0;
+        {
+            std::ofstream out{"zone_map_edited.dat"};
+            for (double value : edited)
+                out << value << "\n";
+        }
+
+        data_analyzer.load_data("zone_map_edited.dat");
+        REQUIRE_THROWS_AS(data_analyzer.load_zone_map("zone_map_edited.dat", "data.dat.zonemap"), std::runtime_error);
+        REQUIRE_FALSE(data_analyzer.has_zone_map());
+    }
+
+    SECTION("text file that is not loaded is rejected")
+    {
+        Ver_2::DataAnalyzer other_analyzer(Ver_2::Statistics::sum);
+
+        REQUIRE_THROWS_AS(other_analyzer.load_zone_map("data.dat"), std::runtime_error);
+        REQUIRE_FALSE(other_analyzer.has_zone_map());
+    }
+}
+
+TEST_CASE("ZoneMap - range queries of binary file without loading data", "[Integration]")
+{
+    Data data = make_random_data(200'000, data_distr);
+    binary_writer("zone_map_data.bin", data);
+    {
+        Ver_2::DataAnalyzer data_analyzer(Ver_2::Statistics::sum, binary_reader);
+        data_analyzer.load_data("zone_map_data.bin");
+        data_analyzer.build_zone_map();
+        data_analyzer.save_zone_map(ZoneMap::sidecar_name("zone_map_data.bin"));
+    }
+
+    Ver_2::DataAnalyzer data_analyzer(Ver_2::Statistics::sum, binary_reader);
+    data_analyzer.enable_metrics();
+    data_analyzer.load_zone_map("zone_map_data.bin");
+    data_analyzer.calculate_range(1234, 198'765);
+
+    const auto& results = data_analyzer.results();
+    REQUIRE(results.size() == 4);
+    REQUIRE(results[0] == StatResult{"Count", 198'765.0 - 1234.0});
+    REQUIRE_THAT(results[1].value, WithinRel(static_cast<double>(std::accumulate(data.begin() + 1234, data.begin() + 198'765, 0.0L)), 1e-9));
+    REQUIRE(results[2].value == *std::min_element(data.begin() + 1234, data.begin() + 198'765));
+    REQUIRE(results[3].value == *std::max_element(data.begin() + 1234, data.begin() + 198'765));
+    REQUIRE(data_analyzer.metrics().values_parsed == 0);
+}
+
+TEST_CASE("ZoneMap - benchmark", "[.][benchmark]")
+{
+    Data data = make_random_data(100'000'000, data_distr);
+    ZoneMap zone_map = ZoneMap::build(data);
+    std::mt19937_64 rnd_gen{42};
+
+    auto random_range = [&] {
+        std::size_t a = rnd_gen() % data.size();
+        std::size_t b = rnd_gen() % data.size();
+        return std::pair{std::min(a, b), std::max(a, b)};
+    };
+
+    BENCHMARK("full scan of random range")
+    {
+        auto [begin, end] = random_range();
+        ZoneSummary summary;
+        summary.add(std::span<const double>{data}.subspan(begin, end - begin));
+        return summary.sum;
+    };
+
+    BENCHMARK("zone map query of random range")
+    {
+        auto [begin, end] = random_range();
+        return zone_map.query(data, begin, end).sum;
+    };
+
+    binary_writer("zone_map_benchmark.bin", data);
+    BinaryFormat::BinaryFile file{"zone_map_benchmark.bin"};
+
+    BENCHMARK("zone map query of random range of mapped file")
+    {
+        auto [begin, end] = random_range();
+        return zone_map.query(file, begin, end).sum;
+    };
+}
@@ -0,0 +1,32 @@
+#include <binary_format.hpp>
+#include <iostream>
+#include <mmap_reader.hpp>
+
+using namespace std;
+
+int main(int argc, char* argv[])
+{
+    if (argc < 2 || argc > 3)
+    {
+        cerr << "Usage: " << argv[0] << " <text_file> [<binary_file>]\n";
+        return 1;
+    }
+
+    const string text_file = argv[1];
+    const string binary_file = (argc == 3) ? argv[2] : text_file + ".bin";
+
+    try
+    {
+        Data data = mmap_reader(text_file);
+        binary_writer(binary_file, data);
+
+        cout << "File " << text_file << " has been converted to " << binary_file << " (" << data.size() << " values)\n";
+    }
+    catch (const exception& e)
+    {
+        cerr << e.what() << "\n";
+        return 1;
+    }
+
+    return 0;
+}